@@ -0,0 +1,47 @@
+#include "Allocations.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static atomic<long long> allocations(0);	//number of calls to operator new so far
+
+//counts the allocation, then allocates like the standard operator new
+void * operator new(size_t size)
+{
+	allocations.fetch_add(1, memory_order_relaxed);
+	if (size == 0)
+		size = 1;
+	while (true)
+	{
+		void * memory = malloc(size);
+		if (memory != nullptr)
+			return memory;
+		new_handler handler = get_new_handler();
+		if (handler == nullptr)
+			throw bad_alloc();
+		handler();
+	}
+}
+
+void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void * memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void * memory) noexcept
+{
+	free(memory);
+}
+
+//returns the number of heap allocations made so far
+long long getAllocationCount()
+{
+	return allocations.load(memory_order_relaxed);
+}
@@ -0,0 +1,12 @@
+//Header file for the allocation counter
+#ifndef ALLOCATIONS_H_
+#define ALLOCATIONS_H_
+
+/* Allocations.cpp replaces the global operator new, so every heap allocation the
+ * program makes through new (including the ones inside the standard containers) is
+ * counted. Reading the count before and after a piece of code shows how many
+ * allocations it made.
+ */
+long long getAllocationCount();		//returns the number of heap allocations made so far
+
+#endif /* ALLOCATIONS_H_ */
@@ -0,0 +1,332 @@
+#include "BatchEngine.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+//boards empty boards of the given size
+BatchEngine::BatchEngine(int boards, int height, int width, bool wrapAround, int maxPeriod)
+{
+	if (boards <= 0 || height <= 0 || width <= 0)
+		throw "A batch needs at least one board of at least one cell";
+	this->boards = boards;
+	this->height = height;
+	this->width = width;
+	this->wrapAround = wrapAround;
+	this->maxPeriod = (maxPeriod > 0) ? maxPeriod : 0;
+	groups = (boards + 63) / 64;
+	rowWords = (width + 2) * groups;
+	cells.assign((height + 2) * (size_t)rowWords, 0);
+	nextCells.assign(cells.size(), 0);
+	history.assign(this->maxPeriod * cells.size(), 0);
+	differs.assign(groups, 0);
+	kernel = &activeKernel();
+	iterations = 0;
+	setRule(CONWAY);
+	restartCycles();
+}
+
+//returns the word of cells (r, c) is in
+uint64_t * BatchEngine::cellWord(int board, int r, int c)
+{
+	return &cells[((r + 1) * (size_t)(width + 2) + c + 1) * groups + (board >> 6)];
+}
+
+//sets the cell of a board to living
+void BatchEngine::toggle(int board, int r, int c, bool living)
+{
+	uint64_t * word = cellWord(board, r, c);
+	uint64_t bit = (uint64_t)1 << (board & 63);
+	*word = living ? (*word | bit) : (*word & ~bit);
+	cyclesKnown = false;
+}
+
+//returns true if the cell of a board is alive
+bool BatchEngine::getCell(int board, int r, int c)
+{
+	return (*cellWord(board, r, c) >> (board & 63)) & 1;
+}
+
+//kills every cell of every board and starts the counters over
+void BatchEngine::clear()
+{
+	fill(cells.begin(), cells.end(), 0);
+	fill(nextCells.begin(), nextCells.end(), 0);
+	iterations = 0;
+	cyclesKnown = false;
+}
+
+//board i gets random cells from seeds[i], as Board::randomize(seed, 0, 0, height, width, ratio) would
+void BatchEngine::randomize(const vector<uint64_t>& seeds, double ratio)
+{
+	if ((int)seeds.size() > boards)
+		throw "There are more seeds than boards";
+	ratio = (ratio < 0) ? 0 : ratio;
+	ratio = (ratio > 1) ? 1 : ratio;
+	const uint64_t threshold = (ratio >= 1) ? ~(uint64_t)0 : (uint64_t)(ratio * 18446744073709551616.0);
+	for (size_t i = 0; i < seeds.size(); i++)
+	{
+		uint64_t seed = seeds[i];
+		for (int r = 0; r < height; r++)
+		{
+			for (int c = 0; c < width; c++)
+			{
+				//splitmix64, one number per cell
+				uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+				z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+				z ^= z >> 31;
+				toggle(i, r, c, z < threshold);
+			}
+		}
+	}
+}
+
+//puts the live cells of a pattern on a board with its top left cell at (top, left), the cells off the board are left out
+void BatchEngine::place(int board, const vector<vector<bool>>& pattern, int top, int left)
+{
+	for (size_t i = 0; i < pattern.size(); i++)
+	{
+		int r = top + i;
+		if (r < 0 || r >= height)
+			continue;
+		for (size_t j = 0; j < pattern[i].size(); j++)
+		{
+			int c = left + j;
+			if (c >= 0 && c < width && pattern[i][j])
+				toggle(board, r, c, true);
+		}
+	}
+}
+
+//puts pattern i in the middle of board i
+void BatchEngine::load(const vector<vector<vector<bool>>>& patterns)
+{
+	if ((int)patterns.size() > boards)
+		throw "There are more patterns than boards";
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		int rows = patterns[i].size(), columns = rows ? patterns[i][0].size() : 0;
+		place(i, patterns[i], (height - rows) / 2, (width - columns) / 2);
+	}
+}
+
+//changes the rule of every board (Larger than Life, Generations and B0 rules are not supported)
+void BatchEngine::setRule(const Rule& rule)
+{
+	if (rule.range > 0)
+		throw "The batch engine cannot run Larger than Life rules";
+	if (rule.dyingStates > 0)
+		throw "The batch engine cannot run Generations rules";
+	if (rule.birth & 1)
+		throw "The batch engine cannot run rules with births on 0 neighbours";
+	this->rule = rule;
+	cyclesKnown = false;
+}
+
+//returns the rule
+Rule BatchEngine::getRule()
+{
+	return rule;
+}
+
+//changes the instruction set the boards are stepped with (for benchmarks)
+void BatchEngine::setKernel(const KernelInfo& kernel)
+{
+	this->kernel = &kernel;
+}
+
+//copies the edges of the boards into the halo (tori only)
+void BatchEngine::fillHalo()
+{
+	for (int r = 1; r <= height; r++)
+	{
+		uint64_t * row = &cells[r * (size_t)rowWords];
+		memcpy(row, row + width * groups, groups * sizeof(uint64_t));
+		memcpy(row + (width + 1) * groups, row + groups, groups * sizeof(uint64_t));
+	}
+	memcpy(&cells[0], &cells[height * (size_t)rowWords], rowWords * sizeof(uint64_t));
+	memcpy(&cells[(height + 1) * (size_t)rowWords], &cells[rowWords], rowWords * sizeof(uint64_t));
+}
+
+//forgets every generation and settled board seen so far
+void BatchEngine::restartCycles()
+{
+	historyLength = 0;
+	settled.assign(groups, 0);
+	//the lanes past the last board are empty, they count as settled so they are never looked at
+	if (boards & 63)
+		settled[groups - 1] = ~(uint64_t)0 << (boards & 63);
+	periods.assign(boards, 0);
+	settledAt.assign(boards, -1);
+	unsettled = boards;
+	cyclesKnown = true;
+}
+
+/* looks for boards back to an earlier generation
+Every generation is compared with each of the last maxPeriod ones, shortest period first, and
+a board that is the same as p generations ago (on every cell) has settled with period p.
+The comparison is done for a whole group of boards with one xor per word.*/
+void BatchEngine::checkCycles()
+{
+	if (maxPeriod == 0 || unsettled == 0)
+		return;
+	const size_t size = cells.size();
+	for (int p = 1; p <= historyLength && p <= maxPeriod && unsettled > 0; p++)
+	{
+		const uint64_t * past = &history[((iterations - p) % maxPeriod) * size];
+		fill(differs.begin(), differs.end(), 0);
+		//only the boards themselves, the halo of a torus is not filled in again until the next generation
+		for (int r = 1; r <= height; r++)
+			for (size_t i = r * (size_t)rowWords + groups; i < (r + 1) * (size_t)rowWords - groups; i += groups)
+				for (int g = 0; g < groups; g++)
+					differs[g] |= cells[i + g] ^ past[i + g];
+		for (int g = 0; g < groups; g++)
+		{
+			uint64_t fresh = ~differs[g] & ~settled[g];
+			settled[g] |= fresh;
+			for (; fresh; fresh &= fresh - 1)
+			{
+				int board = g * 64 + __builtin_ctzll(fresh);
+				periods[board] = p;
+				settledAt[board] = iterations - p;
+				unsettled--;
+			}
+		}
+	}
+	memcpy(&history[(iterations % maxPeriod) * size], cells.data(), size * sizeof(uint64_t));
+	historyLength = min(historyLength + 1, maxPeriod);
+}
+
+/* runs one iteration of every board
+Each row is one call of the batch kernel, and big batches are split into stripes of rows
+that run on every core.*/
+void BatchEngine::runIteration()
+{
+	if (!cyclesKnown)
+		restartCycles();
+	//the generation the boards start from is the first one cycles are compared with
+	if (historyLength == 0 && maxPeriod > 0)
+	{
+		memcpy(&history[(iterations % maxPeriod) * cells.size()], cells.data(), cells.size() * sizeof(uint64_t));
+		historyLength = 1;
+	}
+	if (wrapAround)
+		fillHalo();
+	const int begin = groups, end = (width + 1) * groups;
+	auto stripe = [&](int s, int stripes)
+	{
+		for (int r = 1 + height * s / stripes; r < 1 + height * (s + 1) / stripes; r++)
+		{
+			const uint64_t * row = &cells[r * (size_t)rowWords];
+			kernel->batch(row - rowWords, row, row + rowWords, &nextCells[r * (size_t)rowWords], begin, end, groups, rule);
+		}
+	};
+	//below this many words a generation takes less time than waking the other threads
+	ThreadPool& pool = ThreadPool::shared();
+	int stripes = (cells.size() >= (1 << 16)) ? min(pool.getThreads(), height) : 1;
+	if (stripes > 1)
+	{
+		auto task = [&](int s)
+		{
+			stripe(s, stripes);
+		};
+		pool.run(task, stripes);
+	}
+	else
+	{
+		stripe(0, 1);
+	}
+	cells.swap(nextCells);
+	iterations++;
+	checkCycles();
+}
+
+//runs the given number of iterations
+void BatchEngine::runIteration(long long runs)
+{
+	for (long long i = 0; i < runs; i++)
+		runIteration();
+}
+
+//runs until every board has settled or for the given number of generations, whichever is first
+vector<BatchResult> BatchEngine::run(long long generations)
+{
+	for (long long i = 0; i < generations && !allSettled(); i++)
+		runIteration();
+	return getResults();
+}
+
+//returns the number of live cells of a board
+long long BatchEngine::getPopulation(int board)
+{
+	long long population = 0;
+	for (int r = 0; r < height; r++)
+		for (int c = 0; c < width; c++)
+			population += getCell(board, r, c);
+	return population;
+}
+
+//returns the period a board settled into, 0 if it has not settled
+int BatchEngine::getPeriod(int board)
+{
+	return cyclesKnown ? periods[board] : 0;
+}
+
+//returns the first generation of the cycle a board settled into, -1 if it has not settled
+long long BatchEngine::getSettledAt(int board)
+{
+	return cyclesKnown ? settledAt[board] : -1;
+}
+
+//returns true once every board has settled
+bool BatchEngine::allSettled()
+{
+	return cyclesKnown && unsettled == 0;
+}
+
+//returns the population and cycle of every board
+vector<BatchResult> BatchEngine::getResults()
+{
+	vector<BatchResult> results(boards);
+	vector<long long> populations(groups * 64, 0);
+	//only the live cells are visited, one set bit at a time
+	for (int r = 1; r <= height; r++)
+	{
+		for (int c = 1; c <= width; c++)
+		{
+			const uint64_t * word = &cells[r * (size_t)rowWords + c * groups];
+			for (int g = 0; g < groups; g++)
+				for (uint64_t bits = word[g]; bits; bits &= bits - 1)
+					populations[g * 64 + __builtin_ctzll(bits)]++;
+		}
+	}
+	for (int i = 0; i < boards; i++)
+		results[i] = {populations[i], getPeriod(i), getSettledAt(i)};
+	return results;
+}
+
+//returns the number of boards
+int BatchEngine::getBoards()
+{
+	return boards;
+}
+
+//returns the height of the boards
+int BatchEngine::getHeight()
+{
+	return height;
+}
+
+//returns the width of the boards
+int BatchEngine::getWidth()
+{
+	return width;
+}
+
+//returns the number of iterations that were run
+long long BatchEngine::getIterations()
+{
+	return iterations;
+}
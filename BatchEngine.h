@@ -0,0 +1,85 @@
+//Header file for the batch engine
+#ifndef BATCHENGINE_H_
+#define BATCHENGINE_H_
+
+#include <cstdint>
+#include <vector>
+#include "Kernels.h"
+#include "Rule.h"
+
+//what became of one board of a batch
+struct BatchResult
+{
+	long long population;	//number of live cells
+	int period;				//period the board settled into (1 for still lifes and empty boards), 0 if it has not settled
+	long long settledAt;	//first generation of the cycle it settled into, -1 if it has not settled
+};
+
+/* runs many small boards of the same size in lockstep. The boards are stored side by side:
+ * every cell is a group of words in which bit b of word g is that cell on board g * 64 + b,
+ * so a word holds the same cell of 64 boards, and a generation of every board is one pass of
+ * the batch kernel over the cells, the SIMD lanes of the kernel each taking 64 more boards.
+ * Unlike Board nothing is spent per board (no halo, no tiles, no hash), which is what matters
+ * when the boards are tiny, say thousands of 32x32 collisions or soups.
+ * Every board keeps the last few generations, and a board that is back to one of them has
+ * settled: it is a still life or oscillator from then on. Its period and the generation it
+ * settled are kept, which is what a search running thousands of boards wants to know.
+ */
+class BatchEngine
+{
+	int boards;						//number of boards
+	int height;						//height of every board
+	int width;						//width of every board
+	bool wrapAround;				//true if the boards are tori, otherwise the cells past the edges are dead
+	int groups;						//words per cell, one for every 64 boards
+	int rowWords;					//words in a row of cells, including the dead cell at either end
+	std::vector<uint64_t> cells;	//the cells, row by row, with a row and column of halo all round
+	std::vector<uint64_t> nextCells;	//the next generation is written here, then it swaps roles with cells
+	const KernelInfo * kernel;		//the batch kernel used for every row
+	Rule rule;						//the rule every board runs
+	long long iterations;			//number of iterations that have been run
+
+	int maxPeriod;							//the longest period looked for
+	std::vector<uint64_t> history;			//the last maxPeriod generations, generation t in slot t % maxPeriod
+	int historyLength;						//number of generations in history since the boards were last edited
+	std::vector<uint64_t> differs;			//per group, a bit for every board that is not back to the generation being compared
+	std::vector<uint64_t> settled;			//per group, a bit for every board that has settled
+	std::vector<int> periods;				//the period of every settled board
+	std::vector<long long> settledAt;		//the first generation of the cycle of every settled board
+	int unsettled;							//number of boards that have not settled
+	bool cyclesKnown;						//false once a board was edited, the settled boards are worked out again from the next generation
+
+	uint64_t * cellWord(int board, int r, int c);	//returns the word of cells (r, c) is in
+	void fillHalo();						//copies the edges of the boards into the halo (tori only)
+	void restartCycles();					//forgets every generation and settled board seen so far
+	void checkCycles();						//looks for boards back to an earlier generation
+
+public:
+	BatchEngine(int boards, int height, int width, bool wrapAround = false, int maxPeriod = 6);	//boards empty boards of the given size
+
+	void toggle(int board, int r, int c, bool living);	//sets the cell of a board to living
+	bool getCell(int board, int r, int c);				//returns true if the cell of a board is alive
+	void clear();										//kills every cell of every board and starts the counters over
+	void randomize(const std::vector<uint64_t>& seeds, double ratio = 0.5);	//board i gets random cells from seeds[i], as Board::randomize(seed...) would
+	void place(int board, const std::vector<std::vector<bool>>& pattern, int top, int left);	//puts the live cells of a pattern on a board with its top left cell at (top, left)
+	void load(const std::vector<std::vector<std::vector<bool>>>& patterns);	//puts pattern i in the middle of board i
+	void setRule(const Rule& rule);						//changes the rule of every board (Larger than Life, Generations and B0 rules are not supported)
+	Rule getRule();										//returns the rule
+	void setKernel(const KernelInfo& kernel);			//changes the instruction set the boards are stepped with (for benchmarks)
+
+	void runIteration();								//runs one iteration of every board
+	void runIteration(long long runs);					//runs the given number of iterations
+	std::vector<BatchResult> run(long long generations);	//runs until every board has settled or for the given number of generations, whichever is first
+
+	long long getPopulation(int board);					//returns the number of live cells of a board
+	int getPeriod(int board);							//returns the period a board settled into, 0 if it has not settled
+	long long getSettledAt(int board);					//returns the first generation of the cycle a board settled into, -1 if it has not settled
+	bool allSettled();									//returns true once every board has settled
+	std::vector<BatchResult> getResults();				//returns the population and cycle of every board
+	int getBoards();									//returns the number of boards
+	int getHeight();									//returns the height of the boards
+	int getWidth();										//returns the width of the boards
+	long long getIterations();							//returns the number of iterations that were run
+};
+
+#endif /* BATCHENGINE_H_ */
@@ -1,31 +1,142 @@
 #include "Board.h"
+#include "Macrocell.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
+//what saveState() adds to the rule for each topology, the plane and torus are told apart by the wrap around line
+static const char * const TOPOLOGY_SUFFIXES[] = {"", "", ":K", ":C", ":S"};
+//the letter of each topology in the suffix of a Golly rule string, as RLE and plaintext files are saved with
+static const char TOPOLOGY_LETTERS[] = "PTKCS";
+
+/* the Zobrist key of one word of cells: every word index and contents (64 cells standing
+ * in for a piece on a square) gets its own random looking key, worked out with the
+ * splitmix64 finalizer instead of looked up in a table. The hash of a board is the xor of
+ * the keys of its words, so a generation only has to update the words that changed. A
+ * single multiply does not mix enough: boards a few generations apart got the same hash.
+ */
+static inline uint64_t wordHash(size_t index, uint64_t word)
+{
+	uint64_t h = word + (index + 1) * 0x9e3779b97f4a7c15ULL;
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	return h ^ (h >> 31);
+}
+
+//the change to the hash when words [first, last) of before become the ones of after, word i is keyed as word i + offset of the board
+static uint64_t hashChange(const uint64_t* before, const uint64_t* after, size_t first, size_t last, size_t offset=0)
+{
+	uint64_t change = 0;
+	for (size_t i = first; i < last; i++)
+	{
+		if (before[i] != after[i])
+			change ^= wordHash(i + offset, before[i]) ^ wordHash(i + offset, after[i]);
+	}
+	return change;
+}
+
 //a constructor for the Board class if height, width, and wraparound options are chosen
-Board::Board(bool wrap, int h, int w): matrix(h, vector<bool> (w, 0))
+Board::Board(bool wrap, int h, int w): cells(h * (size_t)((w + 63) / 64), 0)
 {
+	this->wordsPerRow = (w + 63) / 64;
 	this->height = h;
 	this->width = w;
-	this->wrapAround = wrap;
+	this->topology = wrap ? TORUS : PLANE;
 	this->iterations = 0;
 	this->births = 0;
 	this->deaths = 0;
 	isSaved = true;
+	mode = TILES;
+	threads = ThreadPool::shared().getThreads();
+	kernel = &activeKernel();
+	rule = CONWAY;
+	cycles = CYCLES_OFF;
+	resizeBuffers();
 }
 
 //a constructor for the board class if just a filename is given
 Board::Board(string filename)
 {
 	BoardData data = loadFormat(filename);
-	height = data.height;
-	width = data.width;
-	wrapAround = data.wrapAround;
+	topology = data.topology;
+	if (topology == SPHERE && data.height != data.width)
+		throw "A sphere needs a square board";
 	iterations = data.iterations;
 	births = data.births;
 	deaths = data.deaths;
 	isSaved = true;
-	matrix = data.matrix;
+	mode = TILES;
+	threads = ThreadPool::shared().getThreads();
+	kernel = &activeKernel();
+	rule = makeRule(data.birthRule, data.survivalRule, data.range, data.neighbourhood, data.states, data.transitions);
+	cycles = CYCLES_OFF;
+	if (!data.packed.empty())
+		setPacked(data.height, data.width, data.packed);
+	else
+		setMatrix(data.matrix);
+	for (size_t r = 0; r < data.cellStates.size(); r++)
+		for (int c = 0; c < width; c++)
+			if (data.cellStates[r][c] > 1)
+				setState(r, c, data.cellStates[r][c]);
+}
+
+//resizes the board and packs the given matrix into it
+void Board::setMatrix(const vector<vector<bool>>& matrix)
+{
+	height = matrix.size();
+	width = (height > 0) ? matrix[0].size() : 0;
+	wordsPerRow = (width + 63) / 64;
+	cells.assign(height * (size_t)wordsPerRow, 0);
+	for (int r = 0; r < height; r++)
+	{
+		uint64_t * row = &cells[r * (size_t)wordsPerRow];
+		for (int c = 0; c < width; c++)
+		{
+			if (matrix[r][c])
+				row[c >> 6] |= (uint64_t)1 << (c & 63);
+		}
+	}
+	resizeBuffers();
+}
+
+//resizes the board and takes over cells that are already packed (as BoardData::packed), leaving packed empty with the memory of the old cells
+void Board::setPacked(int height, int width, vector<uint64_t>& packed)
+{
+	this->height = height;
+	this->width = width;
+	wordsPerRow = (width + 63) / 64;
+	cells.swap(packed);
+	cells.resize(height * (size_t)wordsPerRow, 0);
+	packed.clear();
+	resizeBuffers();
+}
+
+//sizes the generation buffers to match cells
+void Board::resizeBuffers()
+{
+	nextCells.assign(cells.size(), 0);
+	haloRows.assign(2 * wordsPerRow, 0);
+	haloWest.assign(height + 2, 0);
+	haloEast.assign(height + 2, 0);
+	tileRows = (height + TILE_ROWS - 1) / TILE_ROWS;
+	tileCols = (wordsPerRow + TILE_WORDS - 1) / TILE_WORDS;
+	tileChanged.assign(tileRows * tileCols, 0);
+	nextTileChanged.assign(tileRows * tileCols, 0);
+	//enough planes to count up to the last dying state
+	agePlanes = 0;
+	while ((rule.dyingStates >> agePlanes) != 0)
+		agePlanes++;
+	ages.assign(agePlanes * cells.size(), 0);
+	nextAges.assign(agePlanes * cells.size(), 0);
+	tileBirths.assign(tileRows * tileCols, 0);
+	tileDeaths.assign(tileRows * tileCols, 0);
+	activeTiles.reserve(tileRows * tileCols);
+	tileHashes.assign(tileRows * tileCols, 0);
+	activeTileCount = 0;
+	tilesKnown = false;
+	hashKnown = false;
 }
 
 void Board::toggle(int r, int c)	//toggles the cell from true to false or false to true
@@ -35,7 +146,13 @@ void Board::toggle(int r, int c)	//toggles the cell from true to false or false
 	{
 		return;
 	}
-	matrix[r][c] = !matrix[r][c];
+	size_t word = r * (size_t)wordsPerRow + (c >> 6);
+	uint64_t bit = (uint64_t)1 << (c & 63);
+	//a dying cell is not alive, so it comes back to life
+	cells[word] ^= bit;
+	clearAge(word, bit);
+	tilesKnown = false;
+	hashKnown = false;
 	isSaved = false;
 }
 
@@ -46,160 +163,790 @@ void Board:: toggle(int r, int c, bool isLiving)
 	{
 		return;
 	}
-	matrix[r][c] = isLiving;
+	size_t index = r * (size_t)wordsPerRow + (c >> 6);
+	uint64_t & word = cells[index];
+	uint64_t bit = (uint64_t)1 << (c & 63);
+	word = isLiving ? (word | bit) : (word & ~bit);
+	clearAge(index, bit);
+	tilesKnown = false;
+	hashKnown = false;
+}
+
+//takes the cell off the dying planes
+void Board::clearAge(size_t word, uint64_t bit)
+{
+	for (int k = 0; k < agePlanes; k++)
+		ages[k * cells.size() + word] &= ~bit;
 }
-//allows a board to be randomly generated
-void Board::randomize(double ratio)
+
+//returns true if the cell is alive
+bool Board::getCell(int r, int c)
+{
+	return (cells[r * (size_t)wordsPerRow + (c >> 6)] >> (c & 63)) & 1;
+}
+
+//returns 0 for dead cells, 1 for live ones and 2 and up for dying ones
+int Board::getState(int r, int c)
+{
+	size_t word = r * (size_t)wordsPerRow + (c >> 6);
+	if ((cells[word] >> (c & 63)) & 1)
+		return 1;
+	int age = 0;
+	for (int k = 0; k < agePlanes; k++)
+		age |= ((ages[k * cells.size() + word] >> (c & 63)) & 1) << k;
+	return (age > 0) ? age + 1 : 0;
+}
+
+//sets the state of a cell, states the rule does not have are dead
+void Board::setState(int r, int c, int state)
+{
+	toggle(r, c, state == 1);
+	if (state < 2 || state > rule.dyingStates + 1 || r < 0 || r >= height || c < 0 || c >= width)
+		return;
+	size_t word = r * (size_t)wordsPerRow + (c >> 6);
+	for (int k = 0; k < agePlanes; k++)
+		if (((state - 1) >> k) & 1)
+			ages[k * cells.size() + word] |= (uint64_t)1 << (c & 63);
+}
+
+/* randomizes the given box from a seed, the same seed always gives the same cells
+Unlike randomize() this does not use rand(), so boards on different threads can be filled
+at the same time, and a soup can be made again from nothing but its seed.*/
+void Board::randomize(uint64_t seed, int top, int left, int height, int width, double ratio)
 {
 	ratio = (ratio < 0) ? 0 : ratio;
 	ratio = (ratio > 1) ? 1 : ratio;
-	for (int r = 0; r < height; r++)
+	const uint64_t threshold = (ratio >= 1) ? ~(uint64_t)0 : (uint64_t)(ratio * 18446744073709551616.0);
+	for (int r = top; r < top + height; r++)
 	{
-		for (int c = 0; c < width; c++)
+		for (int c = left; c < left + width; c++)
 		{
-			if (((double)rand()/RAND_MAX) <= ratio)
-			{
-				toggle(r, c);
-			}
+			//splitmix64, one number per cell
+			uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			z ^= z >> 31;
+			toggle(r, c, z < threshold);
 		}
 	}
 }
 
+//kills every cell and starts the counters over, keeping the buffers
+void Board::clear()
+{
+	fill(cells.begin(), cells.end(), 0);
+	fill(ages.begin(), ages.end(), 0);
+	iterations = 0;
+	births = 0;
+	deaths = 0;
+	tilesKnown = false;
+	hashKnown = false;
+	isSaved = false;
+}
+
 //counts how many live neighbours a given cell has
 int Board::numNeigh(int r,int c)
 {
-	/*creating a count variable, setting it equal to -1 if cell is alive (thus
-	avoiding counting it twice)*/
-	int count = ((matrix[r][c]) ? -1 : 0);
-	if (wrapAround)
+	int count = 0;
+	for (int i = r - 1; i <= r + 1; i++)
 	{
-		for (int i = r-1; i <= r+1; i++)
+		for (int j = c - 1; j <= c + 1; j++)
 		{
-			for (int j = c-1; j <= c+1; j++)
-			{
-				//std::cout << "r+i " << r+i << "c+j " << c+j <<std::endl;
-				if ( matrix[((i < 0) ? height+i : i) % height][((j < 0) ? width + j : j) % width])
-					count++;
-			}
+			if (!inNeighbourhood(rule, i - r, j - c))
+				continue;
+			//past the edges the topology decides which cell it is, if any
+			int y = i, x = j;
+			if ((y < 0 || y >= height || x < 0 || x >= width) && !topologyCell(topology, y, x, height, width))
+				continue;
+			if (getCell(y, x))
+				count++;
+		}
+	}
+	return count;
+}
+
+/* fills the halo for the current generation: the packed rows just above and below the
+ * board, and the cells just left and right of every row (the corners included). The
+ * kernels read the cells past the edges from the halo, so they work the same on every
+ * topology and never wrap an index themselves. Filling it costs the perimeter of the
+ * board once per generation.
+ */
+void Board::fillHalo()
+{
+	switch (topology)
+	{
+	case TORUS:
+		fillHaloFor<TorusTopology>();
+		break;
+	case KLEIN_BOTTLE:
+		fillHaloFor<KleinBottleTopology>();
+		break;
+	case CROSS_SURFACE:
+		fillHaloFor<CrossSurfaceTopology>();
+		break;
+	case SPHERE:
+		fillHaloFor<SphereTopology>();
+		break;
+	default:
+		fillHaloFor<PlaneTopology>();
+		break;
+	}
+}
+
+//fillHalo() for the given topology policy
+template <typename TOPOLOGY>
+void Board::fillHaloFor()
+{
+	//the cell that stands at (r, c) outside the board, 0 if there is none
+	auto ghost = [&](int r, int c) -> uint64_t
+	{
+		return TOPOLOGY::cell(r, c, height, width) ? (cells[r * (size_t)wordsPerRow + (c >> 6)] >> (c & 63)) & 1 : 0;
+	};
+	for (int k = 0; k < 2; k++)
+	{
+		uint64_t * row = &haloRows[k * (size_t)wordsPerRow];
+		int r = k ? height : -1;
+		for (int i = 0; i < wordsPerRow; i++)
+			row[i] = 0;
+		for (int c = 0; c < width; c++)
+			row[c >> 6] |= ghost(r, c) << (c & 63);
+	}
+	for (int r = -1; r <= height; r++)
+	{
+		haloWest[r + 1] = ghost(r, -1);
+		haloEast[r + 1] = ghost(r, width);
+	}
+}
+
+/*computes the next generation of words [first, last) of packed row r
+above, row and below point at the three packed rows around the row being computed,
+the result is written to out. The first and last words of a row depend on the edges
+of the board, so they are handled here with the halo; everything in between goes to the row kernel.*/
+void Board::stepRow(int r, const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out,
+	int first, int last, int& born, int& died)
+{
+	const int lastWord = wordsPerRow - 1;
+	const int lastBit = (width - 1) & 63;
+	const uint64_t tailMask = (~(uint64_t)0) >> (63 - lastBit);
+	const uint64_t * rows[3] = {above, row, below};
+
+	int begin = (first > 1) ? first : 1;
+	int end = (last < lastWord) ? last : lastWord;
+	if (begin < end)
+		kernel->kernel(above, row, below, out, begin, end, rule, born, died);
+
+	for (int i = 0; i <= lastWord; i += (lastWord > 0) ? lastWord : 1)
+	{
+		if (i < first || i >= last)
+			continue;
+		uint64_t west[3], east[3];
+		for (int k = 0; k < 3; k++)
+		{
+			//bits that are shifted in from past the edges of the board, row r - 1 + k is at r + k in the halo
+			uint64_t westIn = haloWest[r + k];
+			uint64_t eastIn = haloEast[r + k] << lastBit;
+			west[k] = (rows[k][i] << 1) | ((i > 0) ? rows[k][i - 1] >> 63 : westIn);
+			east[k] = (rows[k][i] >> 1) | ((i < lastWord) ? rows[k][i + 1] << 63 : eastIn);
 		}
+		uint64_t next = ruleWord(rule, west[0], above[i], east[0], west[1], row[i], east[1], west[2], below[i], east[2]);
+		if (i == lastWord)
+			next &= tailMask;
+
+		born += __builtin_popcountll(next & ~row[i]);
+		died += __builtin_popcountll(row[i] & ~next);
+		out[i] = next;
+	}
+}
+
+/*computes the next generation of rows [first, last) into nextCells
+cells is only read, so the rows just outside the range act as halo rows and
+every stripe can be computed at the same time as the others. While cycles are
+looked for, the hash change is added up row by row while the rows are still in cache
+(under Generations rules ageRows() does it, once the cells are final).*/
+void Board::stepRows(int first, int last, int& born, int& died, uint64_t& hashChange)
+{
+	const size_t stride = wordsPerRow;
+	for (int r = first; r < last; r++)
+	{
+		//past the top and bottom edge are the halo rows
+		const uint64_t * above = (r > 0) ? &cells[(r - 1) * stride] : &haloRows[0];
+		const uint64_t * below = (r < height - 1) ? &cells[(r + 1) * stride] : &haloRows[stride];
+		stepRow(r, above, &cells[r * stride], below, &nextCells[r * stride], 0, wordsPerRow, born, died);
+		if (cycles != CYCLES_OFF && agePlanes == 0)
+			hashChange ^= ::hashChange(&cells[0], &nextCells[0], r * stride, (r + 1) * stride);
 	}
-	/*neighbor count nested for loops for wrapAround = false
-	the ternary operators are used to detect when the cell is on the edge of
-	the board*/
-	else {
-		for (int i = ((r == 0) ? 0: r - 1); i <= ((r == height - 1 ) ? r:r+1); i++)
+}
+
+//computes a generation in row stripes (SERIAL and STRIPES modes, and TILES mode under Generations rules)
+void Board::stepStripes()
+{
+	fillHalo();
+	int stripes = (mode == SERIAL) ? 1 : threads;
+	stripes = (stripes < height) ? stripes : height;
+	stripeBirths.assign(stripes, 0);
+	stripeDeaths.assign(stripes, 0);
+	stripeHashes.assign(stripes, 0);
+
+	//each stripe gets an even share of the rows and its own counters
+	auto stripe = [&](int i)
+	{
+		int first = height * (long long)i / stripes, last = height * (long long)(i + 1) / stripes;
+		stepRows(first, last, stripeBirths[i], stripeDeaths[i], stripeHashes[i]);
+		if (agePlanes > 0)
+			ageRows(first, last, stripeBirths[i], stripeHashes[i]);
+	};
+	ThreadPool::shared().run(stripe, stripes);
+
+	//summed in stripe order, so the totals never depend on which thread finished first
+	for (int i = 0; i < stripes; i++)
+	{
+		births += stripeBirths[i];
+		deaths += stripeDeaths[i];
+		hash ^= stripeHashes[i];
+	}
+	cells.swap(nextCells);
+	ages.swap(nextAges);
+	//the tile flags were not kept up to date
+	activeTileCount = tileRows * tileCols;
+	tilesKnown = false;
+}
+
+//true if the tile or any of its 8 neighbours has the change flag set
+bool Board::tileNeighbourhoodChanged(int tile, char flag)
+{
+	int tr = tile / tileCols;
+	int tc = tile % tileCols;
+	//the tiles a twisted edge joins up are not simply the ones on the other side, so edge tiles are always computed
+	bool edge = tr == 0 || tr == tileRows - 1 || tc == 0 || tc == tileCols - 1;
+	if (edge && topology != PLANE && topology != TORUS)
+		return true;
+	for (int i = tr - 1; i <= tr + 1; i++)
+	{
+		for (int j = tc - 1; j <= tc + 1; j++)
 		{
-			for (int j = ((c == 0) ? 0: c - 1); j <= ((c == width - 1) ? c:c+1); j++)
+			int r = i, c = j;
+			//neighbouring tiles wrap around with the board, or are empty past the edge
+			if (topology == TORUS)
+			{
+				r = wrapIndex(r, tileRows);
+				c = wrapIndex(c, tileCols);
+			}
+			else if (r < 0 || r >= tileRows || c < 0 || c >= tileCols)
 			{
-				//std::cout << "r+i " << r+i << "c+j " << c+j <<std::endl;	//for testing purposes
-				if (matrix[i][j])
-					count++;
+				continue;
 			}
+			if (tileChanged[r * tileCols + c] & flag)
+				return true;
 		}
 	}
-	//std::cout << "count:" << count <<endl;	//for testing purposes
-	return count;
+	return false;
 }
 
+/*computes the next generation of a single tile into nextCells
+returns CHANGED_ONE if the result differs from cells (the generation it was computed from)
+and CHANGED_TWO if it differs from what nextCells held before (the generation before that)*/
+char Board::stepTile(int tile, int& born, int& died, uint64_t& hashChange)
+{
+	const size_t stride = wordsPerRow;
+	int firstRow = (tile / tileCols) * TILE_ROWS;
+	int lastRow = (firstRow + TILE_ROWS < height) ? firstRow + TILE_ROWS : height;
+	int firstWord = (tile % tileCols) * TILE_WORDS;
+	int lastWord = (firstWord + TILE_WORDS < wordsPerRow) ? firstWord + TILE_WORDS : wordsPerRow;
+	uint64_t changedOne = 0, changedTwo = 0;
+	uint64_t previous[TILE_WORDS];
+	for (int r = firstRow; r < lastRow; r++)
+	{
+		const uint64_t * above = (r > 0) ? &cells[(r - 1) * stride] : &haloRows[0];
+		const uint64_t * below = (r < height - 1) ? &cells[(r + 1) * stride] : &haloRows[stride];
+		const uint64_t * row = &cells[r * stride];
+		uint64_t * out = &nextCells[r * stride];
+		for (int i = firstWord; i < lastWord; i++)
+			previous[i - firstWord] = out[i];
+		stepRow(r, above, row, below, out, firstWord, lastWord, born, died);
+		for (int i = firstWord; i < lastWord; i++)
+		{
+			changedOne |= out[i] ^ row[i];
+			changedTwo |= out[i] ^ previous[i - firstWord];
+		}
+		if (cycles != CYCLES_OFF)
+			hashChange ^= ::hashChange(&cells[0], &nextCells[0], r * stride + firstWord, r * stride + lastWord);
+	}
+	return (changedOne ? CHANGED_ONE : 0) | (changedTwo ? CHANGED_TWO : 0);
+}
 
-//runs one iteration (for example, when the user presses the "Enter" key in the GameOfLife)
-void Board::runIteration()
+/*computes a generation tile by tile with work stealing (TILES mode)
+Only tiles near recent changes are computed. If a tile and its 8 neighbours did not
+change in the last generation, its next generation is the same as the current one.
+If they are the same as two generations ago, its next generation is the same as the
+previous one. Either way the back buffer already holds the right cells (it holds the
+previous generation), so settled still lifes and blinkers cost nothing at all.*/
+void Board::stepTiles()
 {
+	fillHalo();
+	const int tiles = tileRows * tileCols;
+	//after an edit nothing is known about the tiles, so all of them are computed once
+	bool firstStep = !tilesKnown;
+	if (firstStep)
+	{
+		tileChanged.assign(tiles, CHANGED_ONE | CHANGED_TWO);
+		tilesKnown = true;
+	}
 
-	int **nMatrix = new int*[height];	//creates a new matrix
+	activeTiles.clear();
+	for (int t = 0; t < tiles; t++)
+	{
+		if (tileNeighbourhoodChanged(t, CHANGED_ONE) && tileNeighbourhoodChanged(t, CHANGED_TWO))
+		{
+			activeTiles.push_back(t);
+		}
+		else
+		{
+			//a skipped tile repeats the generation before, so its births are the last deaths and vice versa,
+			//and its hash changes back the same way (tileHashes is left as it is)
+			int born = tileDeaths[t];
+			tileDeaths[t] = tileBirths[t];
+			tileBirths[t] = born;
+			nextTileChanged[t] = tileChanged[t] & CHANGED_ONE;
+		}
+	}
+
+	auto compute = [&](int t)
+	{
+		int born = 0, died = 0;
+		uint64_t change = 0;
+		char changed = stepTile(t, born, died, change);
+		tileBirths[t] = born;
+		tileDeaths[t] = died;
+		tileHashes[t] = change;
+		//the back buffer held cells from before the edit, so it says nothing about two generations ago
+		nextTileChanged[t] = firstStep ? (changed | CHANGED_TWO) : changed;
+	};
+	ThreadPool::shared().runStealing(compute, activeTiles.data(), activeTiles.size());
+
+	//summed in tile order, so the totals never depend on which thread took which tile
+	for (int t = 0; t < tiles; t++)
+	{
+		births += tileBirths[t];
+		deaths += tileDeaths[t];
+	}
+	if (cycles != CYCLES_OFF)
+	{
+		for (int t = 0; t < tiles; t++)
+			hash ^= tileHashes[t];
+	}
+	activeTileCount = activeTiles.size();
+	cells.swap(nextCells);
+	tileChanged.swap(nextTileChanged);
+}
 
-	for (int i = 0; i < height; i++)	//make the second dimension of the matrix
+/*applies the dying states of a Generations rule to rows [first, last) of nextCells
+nextCells holds what the kernel made of the live cells alone. Dying cells cannot be born,
+so they are taken back out (and out of born); every dying cell gets one state older, the
+ones past the last state die for good, and the live cells that did not survive start
+dying. The states are bit sliced, so all of this is done 64 cells at a time.*/
+void Board::ageRows(int first, int last, int& born, uint64_t& hashChange)
+{
+	const size_t plane = cells.size();
+	const int lastAge = rule.dyingStates;
+	for (size_t word = first * (size_t)wordsPerRow; word < last * (size_t)wordsPerRow; word++)
 	{
-		nMatrix[i] = new int[width];
+		uint64_t dying = 0, expired = ~(uint64_t)0;
+		for (int k = 0; k < agePlanes; k++)
+		{
+			uint64_t bits = ages[k * plane + word];
+			dying |= bits;
+			expired &= ((lastAge >> k) & 1) ? bits : ~bits;
+		}
+		expired &= dying;
+		uint64_t next = nextCells[word];
+		born -= __builtin_popcountll(next & dying);
+		next &= ~dying;
+		//adds one to the age of every dying cell, one carry per bit plane
+		uint64_t carry = dying;
+		for (int k = 0; k < agePlanes; k++)
+		{
+			uint64_t bits = ages[k * plane + word];
+			nextAges[k * plane + word] = (bits ^ carry) & ~expired;
+			carry &= bits;
+		}
+		nextAges[word] |= cells[word] & ~next;
+		nextCells[word] = next;
+		//the cells are only final here, and the dying planes are hashed as if they came after them
+		if (cycles != CYCLES_OFF)
+		{
+			hashChange ^= ::hashChange(&cells[0], &nextCells[0], word, word + 1);
+			for (int k = 0; k < agePlanes; k++)
+				hashChange ^= ::hashChange(&ages[0], &nextAges[0], k * plane + word, k * plane + word + 1, plane);
+		}
 	}
-	for(int r = 0; r < height; r++)	//gets the numvber of live neighbours
+}
+
+/*computes a generation under a Larger than Life rule
+The whole board is computed in row stripes (one stripe in SERIAL mode), the running
+sums the counts come from are built along whole rows, so no tiles are skipped.*/
+void Board::stepRange()
+{
+	int stripes = (mode == SERIAL) ? 1 : threads;
+	largerThanLife.step(&cells[0], &nextCells[0], height, width, wordsPerRow, topology, rule,
+		stripes, births, deaths);
+	if (agePlanes > 0 || cycles != CYCLES_OFF)
 	{
-		for(int c = 0; c < width; c++)
+		const size_t stride = wordsPerRow;
+		stripes = (stripes < height) ? stripes : height;
+		stripeBirths.assign(stripes, 0);
+		stripeHashes.assign(stripes, 0);
+		auto stripe = [&](int i)
+		{
+			int first = height * (long long)i / stripes, last = height * (long long)(i + 1) / stripes;
+			if (agePlanes > 0)
+				ageRows(first, last, stripeBirths[i], stripeHashes[i]);
+			else
+				stripeHashes[i] = hashChange(&cells[0], &nextCells[0], first * stride, last * stride);
+		};
+		ThreadPool::shared().run(stripe, stripes);
+		for (int i = 0; i < stripes; i++)
 		{
-			nMatrix[r][c] = numNeigh(r, c);
-			//std::cout << nMatrix[r][c] << " ";
+			births += stripeBirths[i];
+			hash ^= stripeHashes[i];
 		}
-		//std::cout << endl;
 	}
-	//std::cout << "Now we are looking at if the cells do what they are supposed to:\n";
-	for(int r = 0; r < height; r++)	//runs logic based on whether or not a cell is alive and how many live neighbours it has
+	cells.swap(nextCells);
+	ages.swap(nextAges);
+	activeTileCount = tileRows * tileCols;
+	tilesKnown = false;
+}
+
+//runs one iteration (for example, when the user presses the "Enter" key in the GameOfLife)
+void Board::runIteration()
+{
+	if (height == 0 || width == 0)
+	{
+		iterations++;
+		return;
+	}
+	if (cycles != CYCLES_OFF && !hashKnown)
+		restartHistory();
+	if (rule.range > 0)
+		stepRange();
+	else if (mode == TILES && agePlanes == 0)
+		stepTiles();
+	else
+		stepStripes();
+	iterations++;
+	if (cycles != CYCLES_OFF)
+		checkCycle();
+}
+
+/*runs the interation the correct number of times
+Once the board is proven to cycle, CYCLES_STOP returns straight away and CYCLES_SKIP
+jumps over every whole period that is left, only running what remains of the last one.*/
+void Board::runIteration(long long runs)
+{
+	for(long long i = 0; i < runs; i++)
 	{
-		for(int c = 0; c < width; c++)
+		//an edit since the cycle was proven makes getCyclePeriod() 0 again
+		if (getCyclePeriod() > 0)
 		{
-			if(matrix[r][c] == 1)	//if the cell is alive (equal to 1)
+			if (cycles == CYCLES_STOP)
+				return;
+			long long laps = (runs - i) / cyclePeriod;
+			iterations += laps * cyclePeriod;
+			births += laps * cycleBirths;
+			deaths += laps * cycleDeaths;
+			i += laps * cyclePeriod;
+			if (i >= runs)
+				return;
+		}
+		runIteration();
+	}
+}
+
+//runs the iterations with the given execution mode
+void Board::runIteration(long long runs, stepMode mode)
+{
+	stepMode previous = this->mode;
+	this->mode = mode;
+	runIteration(runs);
+	this->mode = previous;
+}
+
+//adds a run of an RLE file, eg "12o", starting a new line first if the run would go past 70 characters
+static void addRun(string& out, size_t& lineStart, long long count, const char * tag)
+{
+	char run[32];
+	int length = 0;
+	if (count > 1)
+	{
+		char digits[24];
+		int n = 0;
+		for (; count > 0; count /= 10)
+			digits[n++] = '0' + count % 10;
+		while (n > 0)
+			run[length++] = digits[--n];
+	}
+	while (*tag != 0)
+		run[length++] = *tag++;
+	if (out.size() - lineStart + length > 70)
+	{
+		out += '\n';
+		lineStart = out.size();
+	}
+	out.append(run, length);
+}
+
+/*save the board as an RLE file, with its rule, topology and counters
+The live runs are found a word at a time: words without live cells are skipped whole, and
+count trailing zeros gives where each run starts and ends. Generations boards have more
+than two states and are written a cell at a time, with the letters of multi-state RLE.
+The file is put together in memory and written at once.*/
+void Board::saveRLE(string fileName)
+{
+	string out = "#C generation " + to_string(iterations) + ", births " + to_string(births) + ", deaths " +
+		to_string(deaths) + "\n";
+	out += "x = " + to_string(width) + ", y = " + to_string(height) + ", rule = " + ruleString(rule) + gollySuffix() + "\n";
+	size_t lineStart = out.size();
+	long long lastRow = 0;
+	for (int r = 0; r < height; r++)
+	{
+		const uint64_t * row = &cells[r * (size_t)wordsPerRow];
+		long long c = 0;
+		if (agePlanes > 0)
+		{
+			//runs of the same state, the dead cells at the end of the row are left out
+			while (c < width)
 			{
-				if(nMatrix[r][c] != 2 && nMatrix[r][c] != 3)
+				int state = getState(r, c);
+				long long end = c + 1;
+				while (end < width && getState(r, end) == state)
+					end++;
+				if (state == 0 && end == width)
+					break;
+				if (r > lastRow)
 				{
-					toggle(r, c);
-					deaths++;
+					addRun(out, lineStart, r - lastRow, "$");
+					lastRow = r;
 				}
-			}
-			else	//if the cell is dead (equal to 0)
-			{
-				if(nMatrix[r][c] == 3)
+				char tag[3] = {'.', 0, 0};
+				if (state > 0)
 				{
-					toggle(r, c);
-					births++;
+					int prefix = (state - 1) / 24;
+					tag[0] = (prefix > 0) ? 'p' + prefix - 1 : 'A' + (state - 1) % 24;
+					tag[1] = (prefix > 0) ? 'A' + (state - 1) % 24 : 0;
 				}
+				addRun(out, lineStart, end - c, tag);
+				c = end;
 			}
+			continue;
+		}
+		for (int w = 0; w < wordsPerRow; )
+		{
+			//the next live cell at or after c
+			uint64_t bits = row[w] & (~(uint64_t)0 << (c & 63));
+			while (bits == 0 && ++w < wordsPerRow)
+				bits = row[w];
+			if (w == wordsPerRow)
+				break;
+			long long start = w * 64LL + __builtin_ctzll(bits);
+			//the next dead cell after it, the bits past the width are always dead
+			bits = ~row[w] & (~(uint64_t)0 << (start & 63));
+			while (bits == 0 && ++w < wordsPerRow)
+				bits = ~row[w];
+			long long end = (w == wordsPerRow) ? width : min((long long)width, w * 64LL + __builtin_ctzll(bits));
+			if (r > lastRow)
+			{
+				addRun(out, lineStart, r - lastRow, "$");
+				lastRow = r;
+			}
+			if (start > c)
+				addRun(out, lineStart, start - c, "b");
+			addRun(out, lineStart, end - start, "o");
+			c = end;
+			w = c >> 6;
+			if (c >= width)
+				break;
 		}
 	}
-	for (int i = 0; i < height; i++)	//delete the matrix that held how many neighbours the cell had (saves space)
+	out += "!\n";
+	ofstream file(fileName, ios::binary);
+	file.write(out.data(), out.size());
+}
+
+/*save the board as a plaintext (.cells) file: a line of '.' and 'O' per row
+The counters and the rule go in '!' comments, and the dead cells at the end of each row
+are left out. Plaintext only has dead and live cells, so dying cells are saved as dead.
+Like saveRLE(), the words without live cells are skipped and the file is written at once.*/
+void Board::saveCells(string fileName)
+{
+	string out = "!Generation " + to_string(iterations) + ", births " + to_string(births) + ", deaths " +
+		to_string(deaths) + "\n";
+	out += "!Rule " + ruleString(rule) + ":" + TOPOLOGY_LETTERS[topology] + "\n";
+	out += "!Size " + to_string(width) + "x" + to_string(height) + "\n";
+	for (int r = 0; r < height; r++)
 	{
-		delete nMatrix[i];
+		const uint64_t * row = &cells[r * (size_t)wordsPerRow];
+		int last = wordsPerRow - 1;
+		while (last >= 0 && row[last] == 0)
+			last--;
+		if (last >= 0)
+		{
+			size_t first = out.size();
+			int length = last * 64 + 64 - __builtin_clzll(row[last]);
+			out.append(length, '.');
+			for (int w = 0; w <= last; w++)
+				for (uint64_t bits = row[w]; bits; bits &= bits - 1)
+					out[first + w * 64 + __builtin_ctzll(bits)] = 'O';
+		}
+		out += '\n';
 	}
-	delete nMatrix;
-	iterations++;
+	ofstream file(fileName, ios::binary);
+	file.write(out.data(), out.size());
+}
 
+/*save the board as a .brd2 file (see BRD2Header)
+The cells and the dying planes are written as they are stored, so saving is three writes
+and a checksum.*/
+void Board::saveBRD2(string fileName)
+{
+	string ruleText = ruleString(rule);
+	BRD2Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BRD2_MAGIC, sizeof(BRD2_MAGIC));
+	header.version = BRD2_VERSION;
+	header.headerSize = sizeof(header) + (ruleText.size() + 7) / 8 * 8;
+	header.height = height;
+	header.width = width;
+	header.topology = topology;
+	header.planes = 1 + agePlanes;
+	header.iterations = iterations;
+	header.births = births;
+	header.deaths = deaths;
+	header.ruleLength = ruleText.size();
+	ruleText.resize(header.headerSize - sizeof(header), '\0');
+	header.dataChecksum = brd2Checksum(cells.data(), cells.size() * sizeof(uint64_t));
+	for (int k = 0; k < agePlanes; k++)
+		header.dataChecksum = brd2Checksum(&ages[k * cells.size()], cells.size() * sizeof(uint64_t), header.dataChecksum);
+	header.headerChecksum = brd2Checksum(ruleText.data(), ruleText.size(), brd2Checksum(&header, sizeof(header)));
+	ofstream out(fileName, ios::binary);
+	out.write((const char *)&header, sizeof(header));
+	out.write(ruleText.data(), ruleText.size());
+	out.write((const char *)cells.data(), cells.size() * sizeof(uint64_t));
+	out.write((const char *)ages.data(), ages.size() * sizeof(uint64_t));
 }
 
-void Board::runIteration(int runs)	//runs the interation the correct number of times
+/*save the board as a macrocell (.mc) file (see Macrocell)
+The size goes in the rule's topology suffix as it does in RLE files, and the births and
+deaths in a comment. Like plaintext, macrocell files only have dead and live cells, so
+dying cells are saved as dead.*/
+void Board::saveMC(string fileName)
 {
-	for(int i = 0; i < runs; i++)
-	{
-		runIteration();
-		//std::cout << "This is the matrix after " << i + 1 << " iterations.\n";	//for testing purposes
-		//getMatrix();
-		//cout << endl;
-	}
+	Macrocell tree;
+	tree.pack(cells, height, width);
+	tree.rule = ruleString(rule) + gollySuffix();
+	tree.generation = iterations;
+	tree.comments.push_back("births " + to_string(births) + ", deaths " + to_string(deaths));
+	tree.save(fileName);
 }
 
-//returns the matrix
-vector<vector<bool>>& Board::getMatrix()
+//the topology and size Golly adds to a rule string, eg ":T100,50" (a sphere only has a width, and a Klein bottle twists its width)
+string Board::gollySuffix()
 {
-	return this->matrix;
+	if (topology == SPHERE)
+		return string(":S") + to_string(width);
+	return string(":") + TOPOLOGY_LETTERS[topology] + to_string(width) + (topology == KLEIN_BOTTLE ? "*," : ",") + to_string(height);
+}
+
+//runs on to the given generation as fast as the board can
+bool Board::jumpTo(long long generation)
+{
+	return jumpTo(generation, nullptr, nullptr);
+}
+
+/*runs on to the given generation, returns false if progress cancelled the jump
+The jump runs in slices as Engine::jumpTo() does, with the tiles skipping the parts of the
+board that have settled and the board looking for cycles (CYCLES_SKIP), so once it is proven
+to repeat itself every period that is left is jumped over at once.*/
+bool Board::jumpTo(long long generation, bool (*progress)(void*, long long), void * context)
+{
+	if (generation < iterations)
+		throw "The board is already past that generation";
+	cycleMode previousCycles = cycles;
+	stepMode previousMode = mode;
+	//a cycle the board already proved is kept
+	if (cycles == CYCLES_OFF)
+		setCycleMode(CYCLES_SKIP);
+	cycles = CYCLES_SKIP;
+	mode = TILES;
+	bool finished = Engine::jumpTo(generation, progress, context);
+	cycles = previousCycles;
+	mode = previousMode;
+	//the hash is not kept up to date without cycle detection, the next time it is turned on it starts over
+	if (cycles == CYCLES_OFF)
+		hashKnown = false;
+	return finished;
+}
+
+//returns an unpacked copy of the matrix
+vector<vector<bool>> Board::getMatrix()
+{
+	vector<vector<bool>> matrix(height, vector<bool> (width, 0));
+	for (int r = 0; r < height; r++)
+		for (int c = 0; c < width; c++)
+			matrix[r][c] = getCell(r, c);
+	return matrix;
 }
 
 //prints the board as a matrix of 1s and 0s
 //very useful for testing purposes
 void Board::printBoard()
 {
-	for(auto row : matrix)
+	for (int r = 0; r < height; r++)
 	{
-		for(auto cell : row)
-			cout << cell << " ";
+		for (int c = 0; c < width; c++)
+			cout << getCell(r, c) << " ";
 		cout << endl;
 	}
 	cout << endl;
 }
 
-//save a given state or board, given a name for the file
+//save a given state or board, given a name for the file, as RLE, plaintext, binary or macrocell if it ends in .rle, .cells, .brd2 or .mc and as .brd otherwise
 void Board::saveState(string fileName)
 {
+	if (endsWith(fileName, ".rle"))
+	{
+		saveRLE(fileName);
+		return;
+	}
+	if (endsWith(fileName, ".cells"))
+	{
+		saveCells(fileName);
+		return;
+	}
+	if (endsWith(fileName, ".brd2"))
+	{
+		saveBRD2(fileName);
+		return;
+	}
+	if (endsWith(fileName, ".mc"))
+	{
+		saveMC(fileName);
+		return;
+	}
 	ofstream out(fileName);
 	out << height << endl;	//first line tells the program the height of the saved matrix
 	out << width << endl;	//second line tells the program the width of the saved matrix
-	out << wrapAround << endl;	//third line tells the program if wrapAround was true or not
+	out << (topology != PLANE) << endl;	//third line tells the program if wrapAround was true or not
 	out << iterations << endl;	//tells the program how many iterations there were
 	out << births << endl;	//how many births there were
 	out << deaths << endl;	//how many deaths there were
+	out << ruleString(rule) << TOPOLOGY_SUFFIXES[topology] << endl;	//which rule the board runs, and the topology if it is not a plane or torus
+	string line(width, '0');
 	for (int i = 0; i < height; i++)	//tells the program what the matrix actually looked like
 	{
 		for (int j = 0; j < width; j++)
 		{
-			out << matrix[i][j];
+			line[j] = '0' + getState(i, j);
 		}
-		out << "\n";
+		out << line << "\n";
 	}
 	out.close();
 }
@@ -224,15 +971,11 @@ void Board::addPattern(string fileName, int x, int y)
 	widthOfSaved = fs_atoi(in);
 
 	//initialize new patternMatrix
-	bool **patternMatrix = new bool *[heightOfSaved];
-	for(int i = 0; i < heightOfSaved; i++)
-	{
-		patternMatrix[i] = new bool[widthOfSaved];
-	}
+	vector<vector<bool>> patternMatrix(heightOfSaved, vector<bool> (widthOfSaved, 0));
 	std::cout << "Created new pattern matrix" << std::endl;
 	//store file values into the patternMatrix
 	int row = 0;
-	while(getline(in, line))
+	while(getline(in, line) && row < heightOfSaved)
 	{
 		for(int i = 0; i <widthOfSaved; i++)
 		{
@@ -250,23 +993,11 @@ void Board::addPattern(string fileName, int x, int y)
 	// used to access the y component of the matrix
 	for(int i = 0; i < heightOfSaved; i++)
 		for(int j = 0; j < widthOfSaved; j++)
-			matrix[x+i][y+j] = patternMatrix[i][j];
+			toggle(x+i, y+j, patternMatrix[i][j]);
 	in.close();
 
 }
 
-//allows the user to add an existing pattern to the board by calling with the actual bool matrix, along with an x and y position
-void Board::addPattern(vector<vector<bool>> patternMatrix, int y, int x)
-{
-	for(size_t i = 0; i < patternMatrix.size(); i++)
-	{
-		for(size_t j = 0; j < patternMatrix[0].size(); j++)
-		{
-			matrix[(y + i) % matrix.size()][(x + j) % matrix[0].size()] = patternMatrix[i][j];
-		}
-	}
-}
-
 //returns the height of the board
 int Board::getHeight()
 {
@@ -280,29 +1011,235 @@ int Board::getWidth()
 }
 
 //returns the number of iterations that were run
-int Board::getIterations()
+long long Board::getIterations()
 {
 	return iterations;
 }
 
 //returns the number of births that occurred
-int Board::getBirths()
+long long Board::getBirths()
 {
 	return this->births;
 }
 
 //returns the number of deaths that occurred
-int Board::getDeaths()
+long long Board::getDeaths()
 {
 	return deaths;
 }
 
+//returns the number of live cells
+long long Board::getPopulation()
+{
+	long long population = 0;
+	for (uint64_t word : cells)
+		population += __builtin_popcountll(word);
+	return population;
+}
+
 //returns a boolean value of if the board has been saved
 bool Board::getIsSaved()
 {
 	return isSaved;
 }
 
+//chooses how runIteration() spreads a generation over the cores
+void Board::setStepMode(stepMode mode)
+{
+	this->mode = mode;
+}
+
+//returns how runIteration() spreads a generation over the cores
+stepMode Board::getStepMode()
+{
+	return mode;
+}
+
+//sets the number of stripes used by the STRIPES mode
+void Board::setThreads(int threads)
+{
+	this->threads = (threads > 0) ? threads : 1;
+}
+
+//returns the number of stripes used by the STRIPES mode
+int Board::getThreads()
+{
+	return threads;
+}
+
+//chooses the row kernel (activeKernel(), lutKernel()...)
+void Board::setKernel(const KernelInfo& kernel)
+{
+	this->kernel = &kernel;
+}
+
+//returns the row kernel in use
+const KernelInfo& Board::getKernel()
+{
+	return *kernel;
+}
+
+//changes the birth and survival rule
+void Board::setRule(const Rule& rule)
+{
+	bool sameStates = rule.dyingStates == this->rule.dyingStates;
+	this->rule = rule;
+	//a different number of states starts every dying cell over as dead
+	if (!sameStates)
+		resizeBuffers();
+	//the tile flags only say what changed under the old rule, and the history was run under it
+	tilesKnown = false;
+	hashKnown = false;
+	isSaved = false;
+}
+
+//changes what lies past the edges (a sphere needs a square board)
+void Board::setTopology(Topology topology)
+{
+	if (topology == SPHERE && height != width)
+		throw "A sphere needs a square board";
+	this->topology = topology;
+	//the tile flags only say what changed with the old edges, and the history was run with them
+	tilesKnown = false;
+	hashKnown = false;
+	isSaved = false;
+}
+
+/*looks for the board repeating itself within the given number of generations
+The board keeps a Zobrist hash of its cells (and dying states) that every generation only
+updates for the words that changed, and a history of the hashes of the last generations.
+As soon as a hash shows up again, the board is copied, and it is proven to be a cycle once
+the board is back to the copy one period later. CYCLES_STOP and CYCLES_SKIP then decide
+what runIteration(runs) does with the generations that are left.*/
+void Board::setCycleMode(cycleMode cycles, int history)
+{
+	this->cycles = cycles;
+	this->history.assign((history > 1) ? history : 1, HistoryEntry());
+	hashKnown = false;
+}
+
+//recomputes the hash and forgets every generation and cycle seen so far
+void Board::restartHistory()
+{
+	hash = boardHash();
+	hashKnown = true;
+	//the skipped tiles keep their hash change from the generation before, which was not worked out
+	tilesKnown = false;
+	historyFirst = iterations;
+	history[iterations % history.size()] = {hash, births, deaths};
+	snapshot.reserve(cells.size() + ages.size());
+	candidatePeriod = 0;
+	cycleStart = -1;
+	cyclePeriod = 0;
+}
+
+//computes the Zobrist hash of the whole board, the dying planes are keyed as if they came after the cells
+uint64_t Board::boardHash()
+{
+	uint64_t h = 0;
+	for (size_t i = 0; i < cells.size(); i++)
+		h ^= wordHash(i, cells[i]);
+	for (size_t i = 0; i < ages.size(); i++)
+		h ^= wordHash(cells.size() + i, ages[i]);
+	return h;
+}
+
+/*records the generation just run, looks for a repeat and proves it
+A repeated hash only suggests a cycle, so the board is copied and compared with the copy
+every generation its hash comes back, until the suggested period is over. The first time
+the board is back to the copy proves the cycle and gives its shortest period, whatever the
+hash suggested. The copy may have been taken some way into the cycle (after two boards with
+the same hash held the search up), so the start is then walked back through the history for
+as long as each board had the hash of the one a period later.
+The history is searched every generation, newest first, even with a copy waiting: a repeat
+that would be proven sooner takes the place of the copy.*/
+void Board::checkCycle()
+{
+	if (cyclePeriod > 0)
+		return;
+	const long long size = history.size();
+	long long oldest = (iterations - size > historyFirst) ? iterations - size : historyFirst;
+	if (candidatePeriod > 0 && hash == snapshotEntry.hash && equal(cells.begin(), cells.end(), snapshot.begin()) &&
+		equal(ages.begin(), ages.end(), snapshot.begin() + cells.size()))
+	{
+		cyclePeriod = iterations - snapshotAt;
+		cycleStart = snapshotAt;
+		while (cycleStart > oldest && history[(cycleStart - 1) % size].hash == history[(cycleStart - 1 + cyclePeriod) % size].hash)
+			cycleStart--;
+		cycleBirths = births - snapshotEntry.births;
+		cycleDeaths = deaths - snapshotEntry.deaths;
+		return;
+	}
+	//two boards with the same hash
+	if (candidatePeriod > 0 && iterations >= snapshotAt + candidatePeriod)
+		candidatePeriod = 0;
+	for (long long g = iterations - 1; g >= oldest; g--)
+	{
+		if (history[g % size].hash != hash)
+			continue;
+		if (candidatePeriod == 0 || iterations + (iterations - g) < snapshotAt + candidatePeriod)
+		{
+			candidatePeriod = iterations - g;
+			snapshotAt = iterations;
+			snapshotEntry = {hash, births, deaths};
+			snapshot.assign(cells.begin(), cells.end());
+			snapshot.insert(snapshot.end(), ages.begin(), ages.end());
+		}
+		break;
+	}
+	history[iterations % size] = {hash, births, deaths};
+}
+
+//returns the birth and survival rule
+Rule Board::getRule()
+{
+	return rule;
+}
+
+//returns the surface the board is
+Topology Board::getTopology()
+{
+	return topology;
+}
+
+//returns the number of tiles computed during the last generation
+int Board::getActiveTiles()
+{
+	return activeTileCount;
+}
+
+//returns the number of tiles the board is split into
+int Board::getTileCount()
+{
+	return tileRows * tileCols;
+}
+
+//returns whether the board looks for cycles
+cycleMode Board::getCycleMode()
+{
+	return cycles;
+}
+
+//returns the Zobrist hash of the cells and dying states
+uint64_t Board::getHash()
+{
+	//the hash is only kept up to date while cycles are looked for
+	return (cycles != CYCLES_OFF && hashKnown) ? hash : boardHash();
+}
+
+//returns the generation the board entered its cycle at, -1 if none was proven yet
+long long Board::getCycleStart()
+{
+	//an edit since the last generation starts the history over
+	return hashKnown ? cycleStart : -1;
+}
+
+//returns the period of the cycle, 0 if none was proven yet
+int Board::getCyclePeriod()
+{
+	return hashKnown ? cyclePeriod : 0;
+}
+
 /*
 	Everything below here is for testing purposes only.
 */
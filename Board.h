@@ -5,23 +5,106 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "Formats.h"
 #include "Util.h"
+#include "Kernels.h"
+#include "LargerThanLife.h"
+#include "Engine.h"
 //#include <SDL2/SDL.h>
 
-class Board
+enum stepMode {SERIAL, STRIPES, TILES};	//how runIteration() spreads a generation over the cores
+enum cycleMode {CYCLES_OFF, CYCLES_STOP, CYCLES_SKIP};	//whether the board looks for cycles, and what runIteration(runs) does once one is proven
+
+class Board : public Engine
 {
 
 protected:	//protected variables
-	std::vector<std::vector<bool>> matrix;	//boolean matrix that will store cells
+	std::vector<uint64_t> cells;			//packed cell storage, 64 cells per word, one row after another
+	int wordsPerRow;						//number of 64-bit words used to store a single row
+	std::vector<uint64_t> nextCells;		//the next generation is written here, then it swaps roles with cells
+	std::vector<uint64_t> haloRows;			//the cells just above the board, then the ones just below it (see fillHalo())
+	std::vector<uint64_t> haloWest;			//the cell just left of each row from -1 to height, 0 or 1
+	std::vector<uint64_t> haloEast;			//the cell just right of each row from -1 to height, 0 or 1
+	std::vector<int> stripeBirths;			//births counted by each stripe during the last generation
+	std::vector<int> stripeDeaths;			//deaths counted by each stripe during the last generation
+	std::vector<uint64_t> stripeHashes;		//hash change of each stripe during the last generation
+	stepMode mode;							//how runIteration() spreads a generation over the cores
+	int threads;							//number of stripes a generation is split into
+	const KernelInfo * kernel;				//the row kernel used for the inside of each row
+	Rule rule;								//the birth and survival rule the board runs
+	LargerThanLife largerThanLife;			//steps the board when the rule is a Larger than Life rule
+	int agePlanes;							//number of bit planes the dying states of a Generations rule take, 0 for other rules
+	std::vector<uint64_t> ages;				//the dying cells, bit sliced: plane k (cells.size() words from k * cells.size()) holds bit k of state - 1
+	std::vector<uint64_t> nextAges;			//the dying cells of the next generation, swaps roles with ages
+
+	static const int TILE_ROWS = 16;		//height of a tile in rows (TILES mode)
+	static const int TILE_WORDS = 16;		//width of a tile in 64-bit words (TILES mode)
+	static const char CHANGED_ONE = 1;		//tileChanged flag: the tile differs from one generation ago
+	static const char CHANGED_TWO = 2;		//tileChanged flag: the tile differs from two generations ago
+	int tileRows;							//number of rows of tiles
+	int tileCols;							//number of columns of tiles
+	std::vector<char> tileChanged;			//for every tile, CHANGED_ONE and/or CHANGED_TWO
+	std::vector<char> nextTileChanged;		//tileChanged for the generation being computed
+	bool tilesKnown;						//false once cells has changed without tileChanged being updated
+	std::vector<int> activeTiles;			//the tiles that have to be computed this generation
+	int activeTileCount;					//number of tiles computed during the last generation
+	std::vector<int> tileBirths;			//births counted by each tile during the last generation
+	std::vector<int> tileDeaths;			//deaths counted by each tile during the last generation
+	std::vector<uint64_t> tileHashes;		//hash change of each tile during the last generation
 	int height;								//height of matrix
 	int width;								//width of matrix
-	bool wrapAround;						//allow the board to wrap around or not
-	int iterations;							//number of iterations that have been run
-	int births;								//number of births so far
-	int deaths;								//number of deaths so far
+	Topology topology;						//the surface the board is, which decides what lies past its edges
+	long long iterations;					//number of iterations that have been run
+	long long births;						//number of births so far
+	long long deaths;						//number of deaths so far
 	bool isSaved;							//once the board has been modified, this is false
 
+	struct HistoryEntry						//what the board looked like after one generation
+	{
+		uint64_t hash;						//hash of the board
+		long long births;					//births so far
+		long long deaths;					//deaths so far
+	};
+	cycleMode cycles;						//whether the board looks for cycles, and what runIteration(runs) does once one is proven
+	uint64_t hash;							//Zobrist hash of the cells and dying states, kept up to date while cycles are looked for
+	bool hashKnown;							//false once the board was edited, the hash is then recomputed and the history started over
+	std::vector<HistoryEntry> history;		//ring buffer of the last generations, generation g is at g % history.size()
+	long long historyFirst;					//oldest generation recorded in history
+	std::vector<uint64_t> snapshot;			//the cells and dying states when a repeated hash was found
+	HistoryEntry snapshotEntry;				//births and deaths when the snapshot was taken
+	long long snapshotAt;					//generation the snapshot was taken at
+	int candidatePeriod;					//period the repeated hash suggests, 0 if there is none to prove
+	long long cycleStart;					//generation the proven cycle started at, -1 if there is none
+	int cyclePeriod;						//period of the proven cycle, 0 if there is none
+	long long cycleBirths;					//births during one period of the proven cycle
+	long long cycleDeaths;					//deaths during one period of the proven cycle
+
+	void setMatrix(const std::vector<std::vector<bool>>& matrix);	//resizes the board and packs the given matrix into it
+	void resizeBuffers();					//sizes the generation buffers to match cells
+	void fillHalo();						//fills the halo with the cells past the edges for the current generation
+	template <typename TOPOLOGY>
+	void fillHaloFor();						//fillHalo() for the given topology policy
+	void stepRow(int r, const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out,
+		int first, int last, int& born, int& died);			//computes the next generation of words [first, last) of packed row r
+	void stepRows(int first, int last, int& born, int& died, uint64_t& hashChange);	//computes the next generation of rows [first, last) into nextCells
+	void stepStripes();								//computes a generation in row stripes (SERIAL and STRIPES modes, and TILES mode under Generations rules)
+	void stepTiles();								//computes a generation tile by tile with work stealing (TILES mode)
+	void stepRange();								//computes a generation under a Larger than Life rule
+	void ageRows(int first, int last, int& born, uint64_t& hashChange);	//applies the dying states of a Generations rule to rows [first, last) of nextCells
+	void clearAge(size_t word, uint64_t bit);		//takes the cell off the dying planes
+	char stepTile(int tile, int& born, int& died, uint64_t& hashChange);	//computes the next generation of a single tile into nextCells, returns its change flags
+	bool tileNeighbourhoodChanged(int tile, char flag);	//true if the tile or any of its 8 neighbours has the change flag set
+	uint64_t boardHash();							//computes the Zobrist hash of the whole board
+	void restartHistory();							//recomputes the hash and forgets every generation and cycle seen so far
+	void checkCycle();								//records the generation just run, looks for a repeat and proves it
+	void saveRLE(std::string fileName);				//saveState() for .rle files
+	void saveCells(std::string fileName);			//saveState() for .cells files
+	void saveBRD2(std::string fileName);			//saveState() for .brd2 files
+	void saveMC(std::string fileName);				//saveState() for .mc files
+	std::string gollySuffix();						//the topology and size Golly adds to a rule string, eg ":T100,50"
+	bool jumpTo(long long generation, bool (*progress)(void*, long long), void * context);	//jumpTo() with the progress callback and its context
+
 public:	//public functions and variables
 
 	Board(bool wrapAround, int height, int width);	//a constructor for the Board class if height, width, and wraparound options are chosen
@@ -29,24 +112,50 @@ public:	//public functions and variables
 	void toggle(int r, int c);						//toggles the cell from true to false or false to true
 	void toggle(int r, int c, bool living);
 
-	void randomize(double ratio=0.5);					//allows a board to be randomly generated
+	using Engine::randomize;						//allows a board to be randomly generated
+	void randomize(uint64_t seed, int top, int left, int height, int width, double ratio=0.5);	//randomizes the given box from a seed, the same seed always gives the same cells
+	void clear();									//kills every cell and starts the counters over, keeping the buffers
+	void setPacked(int height, int width, std::vector<uint64_t>& packed);	//resizes the board and takes over cells that are already packed (as BoardData::packed), leaving packed empty with the memory of the old cells
 	void runIteration();							//runs one iteration (for example, when the user presses the "Enter" key in the GameOfLife)
-	void runIteration(int runs);					//runs the interation the correct number of times
+	void runIteration(long long runs);				//runs the interation the correct number of times
+	void runIteration(long long runs, stepMode mode);		//runs the iterations with the given execution mode
+	bool jumpTo(long long generation);				//runs on to the given generation as fast as the board can
+	using Engine::jumpTo;							//jumpTo() calling progress(iterations) after every slice of the jump
 	void addPattern(std::string fileName, int x, int y);	//allows the user to add an existing pattern to the board by calling with the filename, along with an x and y position
-	void addPattern(std::vector<std::vector<bool>>, int x, int y);	//allows the user to add an existing pattern to the board by calling with the actual bool matrix, along with an x and y position
+	using Engine::addPattern;						//allows the user to add an existing pattern to the board by calling with the actual bool matrix, along with an x and y position
 	void printBoard();								//prints the board as a matrix of 1s and 0s - good for testing purposes
-	void saveState(std::string fileName);			//save a given state or board, given a name for the file
+	void saveState(std::string fileName);			//save a given state or board, given a name for the file (.rle, .cells, .brd2, .mc or else .brd)
 	int numNeigh(int r, int c);						//counts how many live neighbours a given cell has
+	void setStepMode(stepMode mode);				//chooses how runIteration() spreads a generation over the cores
+	void setThreads(int threads);					//sets the number of stripes used by the STRIPES mode
+	void setKernel(const KernelInfo& kernel);		//chooses the row kernel (activeKernel(), lutKernel()...)
+	void setRule(const Rule& rule);					//changes the birth and survival rule
+	void setTopology(Topology topology);			//changes what lies past the edges (a sphere needs a square board)
+	void setCycleMode(cycleMode cycles, int history=1024);	//looks for the board repeating itself within the given number of generations
 
-	//experiment with getting constant?
-	std::vector<std::vector<bool>>& getMatrix();	//returns the matrix
+	bool getCell(int r, int c);						//returns true if the cell is alive
+	int getState(int r, int c);						//returns 0 for dead cells, 1 for live ones and 2 and up for dying ones
+	void setState(int r, int c, int state);			//sets the state of a cell, states the rule does not have are dead
+	std::vector<std::vector<bool>> getMatrix();		//returns an unpacked copy of the matrix
 
 	int getHeight();								//returns the height of the board
 	int getWidth();									//returns the width of the board
-	int getIterations();							//returns the number of iterations that were run
-	int getBirths();								//returns the number of births that occurred
-	int getDeaths();								//returns the number of deaths that occurred
+	long long getIterations();						//returns the number of iterations that were run
+	long long getBirths();							//returns the number of births that occurred
+	long long getDeaths();							//returns the number of deaths that occurred
+	long long getPopulation();						//returns the number of live cells
 	bool getIsSaved();								//returns a boolean value of if the board has been saved
+	stepMode getStepMode();							//returns how runIteration() spreads a generation over the cores
+	int getThreads();								//returns the number of stripes used by the STRIPES mode
+	const KernelInfo& getKernel();					//returns the row kernel in use
+	Rule getRule();									//returns the birth and survival rule
+	Topology getTopology();							//returns the surface the board is
+	int getActiveTiles();							//returns the number of tiles computed during the last generation
+	int getTileCount();								//returns the number of tiles the board is split into
+	cycleMode getCycleMode();						//returns whether the board looks for cycles
+	uint64_t getHash();								//returns the Zobrist hash of the cells and dying states
+	long long getCycleStart();						//returns the generation the board entered its cycle at, -1 if none was proven yet
+	int getCyclePeriod();							//returns the period of the cycle, 0 if none was proven yet
 
 	//void render(SDL_Renderer * renderer, SDL_Rect * renderArea, SDL_Point * cursor);
 };
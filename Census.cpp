@@ -0,0 +1,319 @@
+#include "Census.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+
+using namespace std;
+
+//an empty table
+CensusTable::CensusTable()
+{
+	buckets.assign(1 << 10, -1);
+}
+
+//returns the entry with the key, nullptr if there is none
+CensusEntry * CensusTable::find(uint64_t key)
+{
+	//the keys are hashes already, their low bits are as good as any
+	for (int i = buckets[key & (buckets.size() - 1)]; i >= 0; i = slots[i].next)
+		if (slots[i].key == key)
+			return &slots[i].entry;
+	return nullptr;
+}
+
+//adds an entry whose key is not in the table yet
+void CensusTable::insert(uint64_t key, const CensusEntry& entry)
+{
+	uint64_t bucket = key & (buckets.size() - 1);
+	slots.push_back({key, entry, buckets[bucket]});
+	buckets[bucket] = slots.size() - 1;
+	//keeps the chains short, relinking every entry into twice the buckets
+	if (slots.size() > buckets.size())
+	{
+		buckets.assign(buckets.size() * 2, -1);
+		for (int i = slots.size() - 1; i >= 0; i--)
+		{
+			uint64_t b = slots[i].key & (buckets.size() - 1);
+			slots[i].next = buckets[b];
+			buckets[b] = i;
+		}
+	}
+}
+
+//returns the number of entries
+size_t CensusTable::size()
+{
+	return slots.size();
+}
+
+//returns entry i, in the order they were added
+const CensusEntry& CensusTable::entry(size_t i)
+{
+	return slots[i].entry;
+}
+
+Census::Worker::Worker(const Rule& rule): board(false, BOARD_SIZE, BOARD_SIZE), largeBoard(false, LARGE_BOARD_SIZE, LARGE_BOARD_SIZE),
+	unfinished(0)
+{
+	board.setRule(rule);
+	board.setCycleMode(CYCLES_STOP);
+	largeBoard.setRule(rule);
+	largeBoard.setCycleMode(CYCLES_STOP);
+}
+
+//an empty census of soups made from the seed
+Census::Census(uint64_t seed, const Rule& rule)
+{
+	//the same checks as the classifier, made here rather than inside a worker thread
+	if (rule.dyingStates > 0)
+		throw "The census cannot run Generations rules";
+	if (rule.birth & 1)
+		throw "The census cannot run rules with births on 0 neighbours";
+	this->seed = seed;
+	this->rule = rule;
+	this->soups = 0;
+}
+
+//the seed soup number soup of a census is made from
+uint64_t Census::soupSeed(uint64_t seed, long long soup)
+{
+	uint64_t h = seed ^ ((uint64_t)soup * 0x9e3779b97f4a7c15ULL);
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	return h ^ (h >> 31);
+}
+
+//fills the middle of a board with the soup made from a seed
+void Census::makeSoup(Board& board, uint64_t soupSeed)
+{
+	board.clear();
+	board.randomize(soupSeed, (board.getHeight() - SOUP_SIZE) / 2, (board.getWidth() - SOUP_SIZE) / 2, SOUP_SIZE, SOUP_SIZE);
+}
+
+//classifies an object, from the cache if its phase was seen before
+void Census::classify(Worker& worker, LifeObject& object)
+{
+	uint64_t phase = objectPhaseHash(object);
+	const CensusEntry * known = worker.known.find(phase);
+	if (known == nullptr)
+	{
+		worker.classifier.classify(object, rule, MAX_PERIOD);
+		CensusEntry entry = {object.hash, 0, object.kind, object.period, object.dx, object.dy, object.population, 0};
+		worker.known.insert(phase, entry);
+		return;
+	}
+	const CensusEntry& entry = *known;
+	object.kind = entry.kind;
+	object.period = entry.period;
+	object.dx = entry.dx;
+	object.dy = entry.dy;
+	object.hash = entry.hash;
+}
+
+//the census entry of one copy of a classified object
+static CensusEntry censusEntry(const LifeObject& object, long long soup)
+{
+	//the speed does not depend on which way the object was facing
+	int dx = abs(object.dx), dy = abs(object.dy);
+	CensusEntry entry = {object.hash, 1, object.kind, object.period, max(dx, dy), min(dx, dy), object.population, soup};
+	return entry;
+}
+
+//adds the objects in an entry to the thread's table
+void Census::count(Worker& worker, const CensusEntry& found)
+{
+	CensusEntry * counted = worker.table.find(found.hash);
+	if (counted == nullptr)
+	{
+		worker.table.insert(found.hash, found);
+		return;
+	}
+	CensusEntry& entry = *counted;
+	entry.count += found.count;
+	entry.population = min(entry.population, found.population);
+	entry.firstSoup = min(entry.firstSoup, found.firstSoup);
+}
+
+/* returns true if there are cells on the inside of the edge band or right at the edge
+Nothing gets more than EDGE / 4 cells in EDGE / 4 generations, so whatever flies into the band
+is seen on its inner strip, without looking at the whole band every time.*/
+bool Census::nearEdge(Board& board)
+{
+	const int size = board.getHeight();
+	const int strip[6] = {0, 1, EDGE - 4, EDGE - 3, EDGE - 2, EDGE - 1};
+	for (int k : strip)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			if (board.getCell(k, i) || board.getCell(size - 1 - k, i) ||
+				board.getCell(i, k) || board.getCell(i, size - 1 - k))
+				return true;
+		}
+	}
+	return false;
+}
+
+/* takes off the spaceships near the edge and keeps them in escaped, false if something else got there
+Anything that is not a spaceship would grow into the edge of the board and be cut off by
+it, so the soup cannot be trusted any more.*/
+bool Census::removeSpaceships(Worker& worker, Board& board, long long soup)
+{
+	const int size = board.getHeight();
+	int objects = worker.finder.find(board);
+	for (int i = 0; i < objects; i++)
+	{
+		LifeObject& object = worker.finder.object(i);
+		bool inside = object.top > 1 && object.left > 1 && object.top + object.height < size - 1 &&
+			object.left + object.width < size - 1;
+		//only an object that is all in the edge band is classified, anything still reaching in from
+		//the middle (the soup itself, still growing) would just be a new unclassified phase every time
+		bool band = object.top + object.height <= EDGE || object.left + object.width <= EDGE ||
+			object.top >= size - EDGE || object.left >= size - EDGE;
+		if (!band)
+		{
+			if (inside)
+				continue;
+			return false;
+		}
+		classify(worker, object);
+		if (object.kind != SPACESHIP)
+		{
+			//it can stay until it really gets to the edge
+			if (inside)
+				continue;
+			return false;
+		}
+		worker.escaped.push_back(censusEntry(object, soup));
+		for (int r = 0; r < object.height; r++)
+			for (int c = 0; c < object.width; c++)
+				if (object.cells[r][c])
+					board.toggle(object.top + r, object.left + c, false);
+	}
+	return true;
+}
+
+/* runs a soup on a board until it is proven to cycle, false if it does not get there
+The board is run EDGE / 4 generations at a time and after each run the edge of the board
+is checked for cells. Taking a spaceship off edits the board, which starts its cycle
+detection over.*/
+bool Census::settle(Worker& worker, Board& board, long long soup)
+{
+	makeSoup(board, soupSeed(seed, soup));
+	worker.escaped.clear();
+	while (board.getIterations() < MAX_GENERATIONS)
+	{
+		board.runIteration(EDGE / 4);
+		if (board.getCyclePeriod() > 0)
+			return true;
+		if (nearEdge(board) && !removeSpaceships(worker, board, soup))
+			return false;
+	}
+	return false;
+}
+
+/* runs a soup and counts its objects
+A few soups in a hundred spread out too far for the board, they are run again from the
+start on the large board, so the spaceships they sent off are only counted once.*/
+void Census::runSoup(Worker& worker, long long soup)
+{
+	Board * board = &worker.board;
+	if (!settle(worker, *board, soup))
+	{
+		board = &worker.largeBoard;
+		if (!settle(worker, *board, soup))
+		{
+			worker.unfinished++;
+			return;
+		}
+	}
+	for (auto& entry : worker.escaped)
+		count(worker, entry);
+
+	int objects = worker.finder.find(*board);
+	bool classified = true;
+	for (int i = 0; i < objects && classified; i++)
+	{
+		classify(worker, worker.finder.object(i));
+		classified = worker.finder.object(i).kind != UNCLASSIFIED;
+	}
+	if (classified)
+	{
+		for (int i = 0; i < objects; i++)
+			count(worker, censusEntry(worker.finder.object(i), soup));
+		return;
+	}
+	//some objects only repeat together with their neighbours (a pulsar's four quarters, say),
+	//the classifier puts them back together
+	objects = worker.classifier.classify(*board, MAX_PERIOD);
+	for (int i = 0; i < objects; i++)
+		count(worker, censusEntry(worker.classifier.object(i), soup));
+}
+
+/* runs the next soups, spread over every core
+Every thread takes the next soup number when it is done with one, so a long lived soup
+does not hold the others up.*/
+void Census::run(long long soups)
+{
+	ThreadPool& pool = ThreadPool::shared();
+	int threads = pool.getThreads();
+	while ((int)workers.size() < threads)
+		workers.push_back(unique_ptr<Worker>(new Worker(rule)));
+	const long long first = this->soups, last = first + soups;
+	atomic<long long> next(first);
+	auto task = [&](int t)
+	{
+		long long soup;
+		while ((soup = next.fetch_add(1)) < last)
+			runSoup(*workers[t], soup);
+	};
+	pool.run(task, threads);
+	this->soups = last;
+}
+
+//returns every object found, the most common first
+vector<CensusEntry> Census::getTable()
+{
+	//the threads' tables are added up in hash order, so the result does not depend on which thread ran which soup
+	map<uint64_t, CensusEntry> merged;
+	for (auto& worker : workers)
+	{
+		for (size_t i = 0; i < worker->table.size(); i++)
+		{
+			const CensusEntry& found = worker->table.entry(i);
+			auto it = merged.find(found.hash);
+			if (it == merged.end())
+			{
+				merged[found.hash] = found;
+				continue;
+			}
+			CensusEntry& entry = it->second;
+			entry.count += found.count;
+			entry.population = min(entry.population, found.population);
+			entry.firstSoup = min(entry.firstSoup, found.firstSoup);
+		}
+	}
+	vector<CensusEntry> table;
+	for (auto& item : merged)
+		table.push_back(item.second);
+	stable_sort(table.begin(), table.end(), [](const CensusEntry& a, const CensusEntry& b)
+	{
+		return a.count > b.count;
+	});
+	return table;
+}
+
+//returns the number of soups run so far
+long long Census::getSoups()
+{
+	return soups;
+}
+
+//returns the number of soups that did not settle in MAX_GENERATIONS or outgrew the large board
+long long Census::getUnfinished()
+{
+	long long unfinished = 0;
+	for (auto& worker : workers)
+		unfinished += worker->unfinished;
+	return unfinished;
+}
@@ -0,0 +1,108 @@
+//Header file for the soup census
+#ifndef CENSUS_H_
+#define CENSUS_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Board.h"
+#include "Objects.h"
+
+//one line of the census table: an object and how often it turned up
+struct CensusEntry
+{
+	uint64_t hash;			//LifeObject::hash of the object, the same for every phase and orientation
+	long long count;		//number of times it was found
+	objectKind kind;		//what the object is
+	int period;				//its period, 0 if unclassified
+	int dx;					//the larger of the two distances it moves every period
+	int dy;					//the smaller of the two distances it moves every period
+	int population;			//live cells in its smallest phase that was found
+	long long firstSoup;	//the first soup it was found in, so it can be made again
+};
+
+/* a hash table of census entries, kept in two vectors as Macrocell keeps its nodes: the
+ * entries are chained through their indices, so adding one only allocates when the
+ * vectors double. A census keeps finding phases it has not seen before long after it has
+ * warmed up, a node allocated for each of them would never let it stop allocating.
+ */
+class CensusTable
+{
+	struct Slot
+	{
+		uint64_t key;			//what the entry is found by
+		CensusEntry entry;
+		int next;				//next slot in the same bucket, -1 for the last
+	};
+
+	std::vector<Slot> slots;		//every entry, in the order they were added
+	std::vector<int> buckets;		//heads of the chains through Slot::next, a power of two of them
+
+public:
+	CensusTable();
+	CensusEntry * find(uint64_t key);						//returns the entry with the key, nullptr if there is none
+	void insert(uint64_t key, const CensusEntry& entry);	//adds an entry whose key is not in the table yet
+	size_t size();											//returns the number of entries
+	const CensusEntry& entry(size_t i);						//returns entry i, in the order they were added
+};
+
+/* an apgsearch style census of random soups. Soup i of a census is a SOUP_SIZE by
+ * SOUP_SIZE square of random cells (from soupSeed(seed, i)) in the middle of an empty
+ * BOARD_SIZE board, run until the board is proven to cycle. Spaceships that fly off are
+ * counted and taken off the board when they near the edge, so they neither hold up the
+ * cycle nor crash into the edge. What is left is split into objects and classified, and
+ * every object goes into the census table. The few soups that grow into the edge of the board
+ * are run again on a LARGE_BOARD_SIZE board.
+ * Soups are shared out over every core, each thread with its own boards, object finder,
+ * object classifier and cache of the phases it has classified, so once they are warmed up
+ * a soup only allocates to remember a phase or object that thread has not seen before.
+ * The counts only depend on the seed and the number of soups, not on the threads.
+ */
+class Census
+{
+	//what one thread keeps from soup to soup
+	struct Worker
+	{
+		Board board;										//the board the soups run on
+		Board largeBoard;									//the board soups that outgrow board are run again on
+		ObjectFinder finder;								//splits the board into objects
+		ObjectClassifier classifier;						//classifies the phases not in known, and the soups whose objects only repeat together
+		CensusTable known;									//every phase classified so far, by objectPhaseHash()
+		CensusTable table;									//the objects this thread counted, by LifeObject::hash
+		std::vector<CensusEntry> escaped;					//the spaceships taken off the board during the soup being run
+		long long unfinished;								//soups that did not settle in MAX_GENERATIONS, or outgrew the large board
+
+		Worker(const Rule& rule);
+	};
+
+	uint64_t seed;									//the soups are made from this seed
+	Rule rule;										//the rule the soups run
+	long long soups;								//number of soups run so far
+	std::vector<std::unique_ptr<Worker>> workers;	//one per thread of the shared pool
+
+	void runSoup(Worker& worker, long long soup);	//runs a soup and counts its objects
+	bool settle(Worker& worker, Board& board, long long soup);	//runs a soup on a board until it is proven to cycle, false if it does not get there
+	bool nearEdge(Board& board);						//returns true if there are cells on the inside of the edge band or right at the edge
+	bool removeSpaceships(Worker& worker, Board& board, long long soup);	//takes off the spaceships near the edge and keeps them in escaped, false if something else got there
+	void classify(Worker& worker, LifeObject& object);	//classifies an object, from the cache if its phase was seen before
+	void count(Worker& worker, const CensusEntry& found);	//adds the objects in an entry to the thread's table
+
+public:
+	static const int SOUP_SIZE = 16;				//width and height of a soup
+	static const int BOARD_SIZE = 256;				//width and height of the board a soup runs on
+	static const int LARGE_BOARD_SIZE = 1024;		//width and height of the board for the soups that outgrow it
+	static const int EDGE = 16;						//spaceships this close to the edge are taken off
+	static const int MAX_GENERATIONS = 50000;		//soups that have not settled by then are given up on
+	static const int MAX_PERIOD = 256;				//objects that do not repeat within this many generations are unclassified
+
+	Census(uint64_t seed, const Rule& rule = CONWAY);	//an empty census of soups made from the seed
+	void run(long long soups);						//runs the next soups, spread over every core
+	std::vector<CensusEntry> getTable();			//returns every object found, the most common first
+	long long getSoups();							//returns the number of soups run so far
+	long long getUnfinished();						//returns the number of soups that did not settle, see Worker::unfinished
+
+	static uint64_t soupSeed(uint64_t seed, long long soup);	//the seed soup number soup of a census is made from
+	static void makeSoup(Board& board, uint64_t soupSeed);		//fills the middle of a board with the soup made from a seed
+};
+
+#endif /* CENSUS_H_ */
@@ -0,0 +1,448 @@
+#include "Collisions.h"
+#include "BatchEngine.h"
+#include "Pattern.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+
+using namespace std;
+
+static int gcd(int a, int b)
+{
+	return b ? gcd(b, a % b) : a;
+}
+
+//cuts a matrix down to the bounding box of its live cells, returns false if it has none
+static bool trim(const vector<vector<bool>>& matrix, vector<vector<bool>>& cells, int& top, int& left)
+{
+	int bottom = -1, right = -1;
+	top = left = 1 << 30;
+	for (int r = 0; r < (int)matrix.size(); r++)
+	{
+		for (int c = 0; c < (int)matrix[r].size(); c++)
+		{
+			if (!matrix[r][c])
+				continue;
+			top = min(top, r);
+			bottom = r;
+			left = min(left, c);
+			right = max(right, c);
+		}
+	}
+	if (bottom < 0)
+		return false;
+	cells.assign(bottom - top + 1, vector<bool>(right - left + 1, false));
+	for (int r = top; r <= bottom; r++)
+		for (int c = left; c <= right; c++)
+			cells[r - top][c - left] = matrix[r][c];
+	return true;
+}
+
+/* loads the patterns (looked for in saved/ too) and works out every collision
+Each pattern comes in through Pattern, so it is read by the same loaders as the game's
+patterns, and its orientations are the quarter turns of Pattern::rotate().*/
+CollisionSearch::CollisionSearch(const vector<string>& files, int generations)
+{
+	if (files.size() < 2)
+		throw "A collision needs at least two patterns";
+	this->generations = generations;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		string file = files[i];
+		if (!ifstream(file).good() && ifstream("saved/" + file).good())
+			file = "saved/" + file;
+		Pattern pattern(file);
+		if (i == 0)
+		{
+			rule = pattern.getRule();
+			//the batch engine and the classifier throw on the rules they cannot run, better here than in a worker
+			BatchEngine(1, 1, 1).setRule(rule);
+		}
+		names.push_back(files[i]);
+		orbits.push_back(vector<Orbit>());
+		vector<vector<vector<bool>>> seen;
+		for (int turn = 0; turn < 4; turn++)
+		{
+			vector<vector<bool>> cells;
+			int top, left;
+			if (!trim(pattern.getMatrix(), cells, top, left))
+				throw "A pattern of the collision is empty";
+			if (find(seen.begin(), seen.end(), cells) == seen.end())
+			{
+				seen.push_back(cells);
+				orbits.back().push_back(orbit(cells));
+			}
+			pattern.rotate();
+		}
+	}
+	enumerate();
+}
+
+//runs a pattern through its period, reading the cells of every phase
+CollisionSearch::Orbit CollisionSearch::orbit(const vector<vector<bool>>& matrix)
+{
+	LifeObject object;
+	object.top = object.left = 0;
+	object.height = matrix.size();
+	object.width = matrix[0].size();
+	object.cells = matrix;
+	object.population = 0;
+	for (auto& row : matrix)
+		object.population += count(row.begin(), row.end(), true);
+	classifyObject(object, rule);
+	if (object.kind == UNCLASSIFIED)
+		throw "A pattern of the collision does not repeat itself";
+
+	Orbit orbit;
+	orbit.period = object.period;
+	orbit.dy = object.dy;
+	orbit.dx = object.dx;
+	//nothing gets further than a cell a generation
+	const int margin = orbit.period + 2;
+	Board board(false, object.height + 2 * margin, object.width + 2 * margin);
+	board.setRule(rule);
+	board.setStepMode(SERIAL);
+	board.addPattern(matrix, margin, margin);
+	for (int t = 0; t < orbit.period; t++)
+	{
+		vector<vector<bool>> cells;
+		int top, left;
+		trim(board.getMatrix(), cells, top, left);
+		orbit.phases.push_back(cells);
+		orbit.tops.push_back(top - margin);
+		orbit.lefts.push_back(left - margin);
+		board.runIteration();
+	}
+	return orbit;
+}
+
+//the bounding box of a pattern t generations after it started in phase at (top, left) (where its phase 0 would be)
+CollisionSearch::Box CollisionSearch::boxAt(const Orbit& orbit, int top, int left, int phase, int t)
+{
+	int s = phase + t, laps = s / orbit.period, p = s % orbit.period;
+	Box box;
+	box.top = top + laps * orbit.dy + orbit.tops[p];
+	box.left = left + laps * orbit.dx + orbit.lefts[p];
+	box.bottom = box.top + orbit.phases[p].size() - 1;
+	box.right = box.left + orbit.phases[p][0].size() - 1;
+	return box;
+}
+
+/* works out every collision, the board size and where they go on it
+The first pattern starts at (0, 0). Another pattern moves towards it by rd every l
+generations (l is a period of both), so putting it rd further back and starting it l
+generations earlier gives the same collision. The offsets where it is to be l * n
+generations later are only taken from one such step, 0 <= offset . rd < rd . rd, and n
+is made big enough for the two to start apart. Offsets whose boxes never get within
+reach of each other are a miss and are not kept. With three or more patterns every
+combination of the other patterns' collisions with the first is tried.*/
+void CollisionSearch::enumerate()
+{
+	const int link = 2 * ((rule.range > 0) ? rule.range : 1);
+	const Orbit& first = orbits[0][0];
+	auto apart = [&](const Box& a, const Box& b, int gap)
+	{
+		return a.top - gap > b.bottom || b.top - gap > a.bottom || a.left - gap > b.right || b.left - gap > a.right;
+	};
+
+	//the collisions of each other pattern with the first one
+	vector<vector<CollisionPart>> choices(orbits.size());
+	vector<vector<int>> meetings(orbits.size());
+	for (size_t i = 1; i < orbits.size(); i++)
+	{
+		for (int o = 0; o < (int)orbits[i].size(); o++)
+		{
+			const Orbit& other = orbits[i][o];
+			int l = first.period / gcd(first.period, other.period) * other.period;
+			int rdy = other.dy * (l / other.period) - first.dy * (l / first.period);
+			int rdx = other.dx * (l / other.period) - first.dx * (l / first.period);
+			int step = rdy * rdy + rdx * rdx;
+			if (step == 0)
+				continue;
+			int reach = first.phases[0].size() + first.phases[0][0].size() + other.phases[0].size() +
+				other.phases[0][0].size() + 2 * link + abs(rdy) + abs(rdx);
+			for (int phase = 0; phase < other.period; phase++)
+			{
+				for (int oy = -reach; oy <= reach; oy++)
+				{
+					for (int ox = -reach; ox <= reach; ox++)
+					{
+						int along = oy * rdy + ox * rdx;
+						if (along < 0 || along >= step)
+							continue;
+						int n = 1;
+						while (!apart(boxAt(first, 0, 0, 0, 0), boxAt(other, oy - n * rdy, ox - n * rdx, phase, 0), link + 1))
+							n++;
+						bool meets = false;
+						for (int t = 0; t <= 2 * n * l + l && !meets; t++)
+							meets = !apart(boxAt(first, 0, 0, 0, t), boxAt(other, oy - n * rdy, ox - n * rdx, phase, t), link);
+						if (!meets)
+							continue;
+						choices[i].push_back({(int)i, o, phase, oy - n * rdy, ox - n * rdx});
+						meetings[i].push_back(n * l);
+					}
+				}
+			}
+		}
+		if (choices[i].empty())
+			throw "A pattern of the collision never comes across the path of the first one";
+	}
+
+	//every combination, the first pattern's choice never changes
+	collisions.clear();
+	vector<int> pick(orbits.size(), 0);
+	while (true)
+	{
+		Collision collision;
+		collision.parts.push_back({0, 0, 0, 0, 0});
+		collision.meeting = 0;
+		for (size_t i = 1; i < orbits.size(); i++)
+		{
+			collision.parts.push_back(choices[i][pick[i]]);
+			collision.meeting = max(collision.meeting, meetings[i][pick[i]]);
+		}
+		collisions.push_back(collision);
+		size_t i = 1;
+		while (i < orbits.size() && ++pick[i] == (int)choices[i].size())
+			pick[i++] = 0;
+		if (i == orbits.size())
+			break;
+	}
+	//collisions that meet at about the same time go in the same batches
+	stable_sort(collisions.begin(), collisions.end(), [](const Collision& a, const Collision& b)
+	{
+		return a.meeting < b.meeting;
+	});
+
+	//the board holds every pattern until they meet, with room for what flies off at up to c/2 after that
+	Box all = {0, 0, 0, 0};
+	for (auto& collision : collisions)
+	{
+		for (auto& part : collision.parts)
+		{
+			const Orbit& orbit = orbits[part.pattern][part.orientation];
+			for (int t : {0, collision.meeting})
+			{
+				Box box = boxAt(orbit, part.top, part.left, part.phase, t);
+				all = {min(all.top, box.top), min(all.left, box.left), max(all.bottom, box.bottom), max(all.right, box.right)};
+			}
+		}
+	}
+	const int margin = generations / 2 + 8;
+	height = all.bottom - all.top + 1 + 2 * margin;
+	width = all.right - all.left + 1 + 2 * margin;
+	for (auto& collision : collisions)
+	{
+		for (auto& part : collision.parts)
+		{
+			const Orbit& orbit = orbits[part.pattern][part.orientation];
+			part.top += margin - all.top + orbit.tops[part.phase];
+			part.left += margin - all.left + orbit.lefts[part.phase];
+		}
+	}
+}
+
+//puts the start of a collision on an empty board of getHeight() by getWidth()
+void CollisionSearch::makeCollision(const Collision& collision, Board& board)
+{
+	board.setRule(rule);
+	for (auto& part : collision.parts)
+		board.addPattern(orbits[part.pattern][part.orientation].phases[part.phase], part.top, part.left);
+}
+
+//the sorted hashes of the objects on a board, to compare an outcome with a target
+vector<uint64_t> CollisionSearch::objectHashes(Engine& board)
+{
+	vector<uint64_t> hashes;
+	for (auto& object : classifyObjects(board))
+		hashes.push_back(object.hash);
+	sort(hashes.begin(), hashes.end());
+	return hashes;
+}
+
+//classifies an object, from the cache if its phase was seen before
+void CollisionSearch::classify(Worker& worker, LifeObject& object)
+{
+	uint64_t phase = objectPhaseHash(object);
+	auto it = worker.known.find(phase);
+	if (it == worker.known.end())
+	{
+		classifyObject(object, rule, MAX_PERIOD);
+		worker.known[phase] = object;
+		return;
+	}
+	const LifeObject& known = it->second;
+	object.kind = known.kind;
+	object.period = known.period;
+	object.dx = known.dx;
+	object.dy = known.dy;
+	object.hash = known.hash;
+}
+
+/* runs collisions [first, first + count) side by side
+Every collision runs until the latest of them has had generations more than it took to
+meet (or until they have all settled), then each board is read back and classified. Most
+collisions leave the same few objects, so they come from the thread's cache, and only
+when an object does not repeat on its own (a part of a bigger oscillator, say) are the
+objects of the board put back together by classifyObjects().*/
+void CollisionSearch::runBatch(Worker& worker, int first, int count, vector<CollisionResult>& results)
+{
+	BatchEngine engine(count, height, width);
+	engine.setRule(rule);
+	int meeting = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const Collision& collision = collisions[first + i];
+		for (auto& part : collision.parts)
+			engine.place(i, orbits[part.pattern][part.orientation].phases[part.phase], part.top, part.left);
+		meeting = max(meeting, collision.meeting);
+	}
+	engine.run(meeting + generations);
+
+	Board board(false, height, width);
+	board.setRule(rule);
+	board.setStepMode(SERIAL);
+	for (int i = 0; i < count; i++)
+	{
+		CollisionResult& result = results[first + i];
+		board.clear();
+		result.edge = false;
+		for (int r = 0; r < height; r++)
+		{
+			for (int c = 0; c < width; c++)
+			{
+				if (!engine.getCell(i, r, c))
+					continue;
+				board.toggle(r, c, true);
+				result.edge |= r == 0 || c == 0 || r == height - 1 || c == width - 1;
+			}
+		}
+		int objects = worker.finder.find(board);
+		bool classified = true;
+		for (int j = 0; j < objects && classified; j++)
+		{
+			classify(worker, worker.finder.object(j));
+			classified = worker.finder.object(j).kind != UNCLASSIFIED;
+		}
+		result.objects.clear();
+		if (classified)
+		{
+			for (int j = 0; j < objects; j++)
+				result.objects.push_back(worker.finder.object(j));
+		}
+		else
+		{
+			result.objects = classifyObjects(board, MAX_PERIOD);
+		}
+		sort(result.objects.begin(), result.objects.end(), [](const LifeObject& a, const LifeObject& b)
+		{
+			return a.hash != b.hash ? a.hash < b.hash : a.dx != b.dx ? a.dx < b.dx : a.dy < b.dy;
+		});
+		result.hash = mix(result.objects.size() + (result.edge ? 1ULL << 63 : 0));
+		for (auto& object : result.objects)
+			result.hash = mix(result.hash ^ object.hash);
+		result.count = 1;
+		result.example = collisions[first + i];
+	}
+}
+
+/* runs every collision and returns what they left, the most common first
+The batches are shared out over every core, each with its own BatchEngine. The results
+are put together in the order of the collisions, so they do not depend on the threads.*/
+vector<CollisionResult> CollisionSearch::run()
+{
+	vector<CollisionResult> results(collisions.size());
+	const int batches = (collisions.size() + BATCH - 1) / BATCH;
+	ThreadPool& pool = ThreadPool::shared();
+	vector<Worker> workers(min(pool.getThreads(), batches));
+	atomic<int> next(0);
+	auto task = [&](int t)
+	{
+		int batch;
+		while ((batch = next.fetch_add(1)) < batches)
+			runBatch(workers[t], batch * BATCH, min(BATCH, (int)collisions.size() - batch * BATCH), results);
+	};
+	pool.run(task, workers.size());
+
+	map<uint64_t, int> index;
+	vector<CollisionResult> outcomes;
+	for (auto& result : results)
+	{
+		auto it = index.find(result.hash);
+		if (it == index.end())
+		{
+			index[result.hash] = outcomes.size();
+			outcomes.push_back(result);
+			continue;
+		}
+		outcomes[it->second].count++;
+	}
+	stable_sort(outcomes.begin(), outcomes.end(), [](const CollisionResult& a, const CollisionResult& b)
+	{
+		return a.count > b.count;
+	});
+	return outcomes;
+}
+
+//lists the objects a collision left, eg "2 x still life (4 cells), spaceship (5 cells, period 4, moving 1,1)"
+string CollisionSearch::describe(const CollisionResult& result)
+{
+	if (result.objects.empty())
+		return result.edge ? "nothing (reached the edge)" : "nothing";
+	string text;
+	for (size_t i = 0; i < result.objects.size();)
+	{
+		const LifeObject& object = result.objects[i];
+		size_t same = i;
+		//the hash is the same whichever way an object faces, spaceships going different ways are told apart by their velocity
+		while (same < result.objects.size() && result.objects[same].hash == object.hash &&
+			result.objects[same].dx == object.dx && result.objects[same].dy == object.dy)
+			same++;
+		if (!text.empty())
+			text += ", ";
+		if (same - i > 1)
+			text += to_string(same - i) + " x ";
+		text += objectKindName(object.kind) + " (" + to_string(object.population) + " cells";
+		if (object.period > 1)
+			text += ", period " + to_string(object.period);
+		if (object.kind == SPACESHIP)
+			text += ", moving " + to_string(object.dx) + "," + to_string(object.dy);
+		text += ")";
+		i = same;
+	}
+	return result.edge ? text + " (reached the edge)" : text;
+}
+
+//says where each pattern of a collision starts, eg "glider.rle turn 0 phase 0 at 136,136"
+string CollisionSearch::describe(const Collision& collision)
+{
+	string text;
+	for (auto& part : collision.parts)
+	{
+		if (!text.empty())
+			text += ", ";
+		text += names[part.pattern] + " turn " + to_string(part.orientation) + " phase " + to_string(part.phase) +
+			" at " + to_string(part.top) + "," + to_string(part.left);
+	}
+	return text;
+}
+
+//returns the number of collisions that will be run
+int CollisionSearch::getCollisions()
+{
+	return collisions.size();
+}
+
+//returns the height of the collision boards
+int CollisionSearch::getHeight()
+{
+	return height;
+}
+
+//returns the width of the collision boards
+int CollisionSearch::getWidth()
+{
+	return width;
+}
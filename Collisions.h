@@ -0,0 +1,107 @@
+//Header file for the collision search
+#ifndef COLLISIONS_H_
+#define COLLISIONS_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Board.h"
+#include "Objects.h"
+
+//one of the patterns of a collision, as it is put on the board
+struct CollisionPart
+{
+	int pattern;		//which of the search's patterns it is
+	int orientation;	//which of its distinct quarter turns (Pattern::rotate() applied this many times, duplicates left out)
+	int phase;			//the generation of its period it starts in
+	int top;			//top row of its cells on the collision board
+	int left;			//left column of its cells on the collision board
+};
+
+//the patterns of one collision, the first one is always the first pattern in orientation 0 and phase 0
+struct Collision
+{
+	std::vector<CollisionPart> parts;
+	int meeting;		//the generation the patterns are expected to meet by
+};
+
+//what a set of collisions left behind
+struct CollisionResult
+{
+	uint64_t hash;						//the same for every collision that leaves the same objects, wherever they are and whichever way they face
+	std::vector<LifeObject> objects;	//the objects left, sorted by their hash
+	bool edge;							//true if something reached the edge of the board, so the objects cannot be trusted
+	long long count;					//number of collisions that gave it
+	Collision example;					//the first of them
+};
+
+/* searches every collision between a few moving patterns (gliders, spaceships, or
+ * spaceships and still lifes). The first pattern stays put in orientation 0 and phase 0;
+ * every other one is tried in each of its orientations (the quarter turns of
+ * Pattern::rotate()) and phases and on every lane and timing that brings it across the
+ * path of the first one. Lanes that never come close are left out without being run.
+ * The collisions run side by side on a BatchEngine, a batch of them per core, and what
+ * each one leaves is split into objects and classified, each thread keeping the phases it
+ * has classified as the census does. Collisions that leave the same objects are put
+ * together under one hash.
+ */
+class CollisionSearch
+{
+	//one orientation of a pattern and every phase of its period
+	struct Orbit
+	{
+		std::vector<std::vector<std::vector<bool>>> phases;	//the cells of every phase, cut down to their bounding box
+		std::vector<int> tops;				//top row of every phase, from the top row of phase 0
+		std::vector<int> lefts;				//left column of every phase, from the left column of phase 0
+		int period;							//generations in a period
+		int dy;								//rows it moves down every period
+		int dx;								//columns it moves right every period
+	};
+
+	//where a pattern is after t generations, relative to its phase 0 at (top, left)
+	struct Box
+	{
+		int top;
+		int left;
+		int bottom;
+		int right;
+	};
+
+	//what one thread keeps from batch to batch
+	struct Worker
+	{
+		ObjectFinder finder;								//splits the boards into objects
+		std::unordered_map<uint64_t, LifeObject> known;		//every phase classified so far, by objectPhaseHash()
+	};
+
+	std::vector<std::string> names;					//the file of every pattern
+	std::vector<std::vector<Orbit>> orbits;			//the distinct orientations of every pattern
+	Rule rule;										//the rule of the first pattern, every collision runs it
+	int generations;								//generations every collision runs for after the patterns meet
+	std::vector<Collision> collisions;				//every collision to run
+	int height;										//height of the collision boards
+	int width;										//width of the collision boards
+
+	Orbit orbit(const std::vector<std::vector<bool>>& matrix);	//runs a pattern through its period
+	Box boxAt(const Orbit& orbit, int top, int left, int phase, int t);	//the bounding box of a pattern t generations after it started in phase at (top, left)
+	void enumerate();								//works out every collision, the board size and where they go on it
+	void classify(Worker& worker, LifeObject& object);	//classifies an object, from the cache if its phase was seen before
+	void runBatch(Worker& worker, int first, int count, std::vector<CollisionResult>& results);	//runs collisions [first, first + count) side by side
+
+public:
+	static const int BATCH = 256;					//collisions run side by side on each core
+	static const int MAX_PERIOD = 64;				//objects left that do not repeat within this many generations are unclassified
+
+	CollisionSearch(const std::vector<std::string>& files, int generations = 256);	//loads the patterns (looked for in saved/ too) and works out every collision
+	std::vector<CollisionResult> run();				//runs every collision and returns what they left, the most common first
+	void makeCollision(const Collision& collision, Board& board);	//puts the start of a collision on an empty board of getHeight() by getWidth()
+	std::string describe(const CollisionResult& result);	//lists the objects a collision left, eg "2 x still life (4 cells)"
+	std::string describe(const Collision& collision);	//says where each pattern of a collision starts
+	std::vector<uint64_t> objectHashes(Engine& board);	//the sorted hashes of the objects on a board, to compare an outcome with a target
+	int getCollisions();							//returns the number of collisions that will be run
+	int getHeight();								//returns the height of the collision boards
+	int getWidth();									//returns the width of the collision boards
+};
+
+#endif /* COLLISIONS_H_ */
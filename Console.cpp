@@ -0,0 +1,392 @@
+#include "Console.h"
+#include "Allocations.h"
+#include "BatchEngine.h"
+#include "Board.h"
+#include "Census.h"
+#include "Collisions.h"
+#include "Engine.h"
+#include "Kernels.h"
+#include "Library.h"
+#include "Objects.h"
+#include "ThreadPool.h"
+#include "Util.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//prints the console commands
+static void printUsage()
+{
+	cout << "Usage: GameOfGenes [command]" << endl;
+	cout << "Without a command the game window opens. Commands:" << endl;
+	cout << "  --bench [file] [generations]   times every generation kernel the cpu supports" << endl;
+	cout << "                                 on the file (or a 2048x2048 random board)" << endl;
+	cout << "  --run [file] [generations] [--engine hashlife|sparse]" << endl;
+	cout << "                                 runs the file (or a 2048x2048 random board) and" << endl;
+	cout << "                                 stops once it is proven to repeat itself (the Board" << endl;
+	cout << "                                 only, HashLife and the sparse plane run every generation)" << endl;
+	cout << "  --classify file [generations]  runs the file for the given generations (0 by default)," << endl;
+	cout << "                                 then lists its objects with their period and speed" << endl;
+	cout << "  --batch [boards] [size] [generations]" << endl;
+	cout << "                                 times every kernel on a batch of random boards (4096" << endl;
+	cout << "                                 32x32 by default) stepped side by side" << endl;
+	cout << "  --census [soups] [seed] [rule] runs random 16x16 soups (10000 by default) until they" << endl;
+	cout << "                                 settle and prints how often each object turned up" << endl;
+	cout << "  --soup seed number file        saves soup number of a census as a .brd file" << endl;
+	cout << "  --collide a.rle b.rle [more] [--target empty|file] [--gens generations] [--save prefix]" << endl;
+	cout << "                                 runs every collision of the patterns and lists what they" << endl;
+	cout << "                                 leave, or only the collisions that leave the target" << endl;
+	cout << "  --library [text]               brings the index of saved/ up to date and lists the" << endl;
+	cout << "                                 patterns whose name, rule or comments contain the text" << endl;
+}
+
+/* times every generation kernel on the same board. STRIPES mode is used so every
+ * generation computes every cell and the kernels are compared like for like; the
+ * population is printed too, and has to agree between the kernels. The first
+ * generation sizes the board's buffers, after that stepping should not allocate at all.
+ */
+static int bench(int argc, char** args)
+{
+	Board * start;
+	if (argc > 2)
+	{
+		start = new Board(string(args[2]));
+	}
+	else
+	{
+		start = new Board(true, 2048, 2048);
+		srand(1);
+		start->randomize(0.3);
+	}
+	int generations = (argc > 3) ? atoi(args[3]) : 200;
+
+	cout << "Board " << start->getHeight() << "x" << start->getWidth() << ", " << generations
+		<< " generations, " << start->getThreads() << " threads" << endl;
+	cout << left << setw(10) << "kernel" << right << setw(12) << "gen/s" << setw(12) << "Mcells/s"
+		<< setw(14) << "population" << setw(10) << "allocs" << endl;
+	for (const KernelInfo * kernel : availableKernels())
+	{
+		Board board = *start;
+		board.setKernel(*kernel);
+		board.setStepMode(STRIPES);
+		board.runIteration();
+		long long allocations = getAllocationCount();
+		auto begin = chrono::steady_clock::now();
+		board.runIteration(generations);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		allocations = getAllocationCount() - allocations;
+		double cells = (double)board.getHeight() * board.getWidth() * generations;
+		cout << left << setw(10) << kernel->name << right << fixed << setprecision(1)
+			<< setw(12) << generations / seconds << setw(12) << cells / seconds / 1e6
+			<< setw(14) << board.getPopulation() << setw(10) << allocations << endl;
+	}
+	delete start;
+	return 0;
+}
+
+/* times every batch kernel on the same boards, then runs them until they settle. The boards
+ * are random, each from its own seed, and the number that settled (with a period of up to
+ * 6) is printed along with how fast the boards were stepped.
+ */
+static int batch(int argc, char** args)
+{
+	int boards = (argc > 2) ? atoi(args[2]) : 4096;
+	int size = (argc > 3) ? atoi(args[3]) : 32;
+	int generations = (argc > 4) ? atoi(args[4]) : 1000;
+	vector<uint64_t> seeds(boards);
+	for (int i = 0; i < boards; i++)
+		seeds[i] = i;
+
+	cout << boards << " boards " << size << "x" << size << ", " << generations << " generations, "
+		<< ThreadPool::shared().getThreads() << " threads" << endl;
+	cout << left << setw(10) << "kernel" << right << setw(16) << "board gen/s" << setw(12) << "Mcells/s"
+		<< setw(10) << "settled" << setw(10) << "allocs" << endl;
+	for (const KernelInfo * kernel : availableKernels())
+	{
+		BatchEngine engine(boards, size, size);
+		engine.setKernel(*kernel);
+		engine.randomize(seeds, 0.5);
+		engine.runIteration();
+		long long allocations = getAllocationCount();
+		auto begin = chrono::steady_clock::now();
+		engine.runIteration(generations);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		allocations = getAllocationCount() - allocations;
+		int settled = 0;
+		for (auto& result : engine.getResults())
+			settled += result.period > 0;
+		double steps = (double)boards * generations;
+		cout << left << setw(10) << kernel->name << right << fixed << setprecision(1)
+			<< setw(16) << steps / seconds << setw(12) << steps * size * size / seconds / 1e6
+			<< setw(10) << settled << setw(10) << allocations << endl;
+	}
+	return 0;
+}
+
+/* runs a board for up to the given number of generations with cycle detection on, so a
+ * random board that settles into still lifes and oscillators stops as soon as that is
+ * proven instead of running the rest of the generations for nothing. With --engine the
+ * board is run by HashLife or the sparse plane instead, which do not look for cycles.
+ */
+static int run(int argc, char** args)
+{
+	vector<string> values;
+	engineType type = BOARD_ENGINE;
+	for (int i = 2; i < argc; i++)
+	{
+		string arg = args[i];
+		if (arg != "--engine")
+		{
+			values.push_back(arg);
+			continue;
+		}
+		string name = (i + 1 < argc) ? args[++i] : "";
+		if (name == "hashlife")
+			type = HASHLIFE_ENGINE;
+		else if (name == "sparse")
+			type = SPARSE_ENGINE;
+		else
+			throw "--run needs hashlife or sparse after --engine";
+	}
+	Engine * board;
+	if (!values.empty())
+	{
+		board = makeEngine(type, values[0]);
+	}
+	else
+	{
+		board = makeEngine(type, true, 2048, 2048);
+		srand(1);
+		board->randomize(0.3);
+	}
+	long long generations = (values.size() > 1) ? atoll(values[1].c_str()) : 100000;
+
+	Board * packed = (type == BOARD_ENGINE) ? static_cast<Board*>(board) : nullptr;
+	if (packed != nullptr)
+		packed->setCycleMode(CYCLES_STOP);
+	auto begin = chrono::steady_clock::now();
+	board->runIteration(generations);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	if (packed != nullptr && packed->getCyclePeriod() > 0)
+		cout << "Board entered period " << packed->getCyclePeriod() << " at generation " << packed->getCycleStart() << endl;
+	else if (packed != nullptr)
+		cout << "No cycle found" << endl;
+	cout << "Ran " << board->getIterations() << " generations in " << fixed << setprecision(2) << seconds
+		<< " s, population " << board->getPopulation() << endl;
+	delete board;
+	return 0;
+}
+
+/* runs a board for the given number of generations, then splits it into objects and
+ * prints what each one is: still life, oscillator (with its period) or spaceship (with its
+ * period and how far it moves every period), followed by a count of each kind.
+ */
+static int classify(int argc, char** args)
+{
+	if (argc < 3)
+		throw "--classify needs a file";
+	Board board((string(args[2])));
+	long long generations = (argc > 3) ? atoll(args[3]) : 0;
+	board.runIteration(generations);
+
+	vector<LifeObject> objects = classifyObjects(board);
+	int counts[UNCLASSIFIED + 1] = {0};
+	cout << right << setw(6) << "row" << setw(6) << "col" << setw(10) << "size" << setw(8) << "cells"
+		<< "  " << left << setw(14) << "kind" << right << setw(8) << "period" << setw(6) << "dx" << setw(6) << "dy" << endl;
+	for (auto& object : objects)
+	{
+		string size = to_string(object.width) + "x" + to_string(object.height);
+		cout << right << setw(6) << object.top << setw(6) << object.left << setw(10) << size << setw(8) << object.population
+			<< "  " << left << setw(14) << objectKindName(object.kind) << right << setw(8) << object.period
+			<< setw(6) << object.dx << setw(6) << object.dy << endl;
+		counts[object.kind]++;
+	}
+	cout << objects.size() << " objects:";
+	for (int kind = STILL_LIFE; kind <= UNCLASSIFIED; kind++)
+		cout << " " << counts[kind] << " " << objectKindName((objectKind)kind) << ((kind < UNCLASSIFIED) ? "," : "");
+	cout << endl;
+	return 0;
+}
+
+/* runs a census of random soups and prints the table, the most common objects first.
+ * A fifth of the soups (at least 100) are run first so every thread has its boards and
+ * buffers at the size the biggest objects need, the rest are timed and the allocations
+ * they make are counted, which should be close to none.
+ */
+static int census(int argc, char** args)
+{
+	long long soups = (argc > 2) ? atoll(args[2]) : 10000;
+	uint64_t seed = (argc > 3) ? strtoull(args[3], nullptr, 10) : 1;
+	Rule rule = CONWAY;
+	if (argc > 4)
+	{
+		set<int> birthRule, survivalRule;
+		int range, states;
+		char neighbourhood;
+		vector<bool> transitions;
+		if (!string2rule(args[4], birthRule, survivalRule, range, neighbourhood, states, transitions))
+			throw "--census needs a rule like B3/S23";
+		rule = makeRule(birthRule, survivalRule, range, neighbourhood, states, transitions);
+	}
+
+	Census census(seed, rule);
+	long long warmup = min(soups, max(soups / 5, 100LL));
+	census.run(warmup);
+	long long allocations = getAllocationCount();
+	auto begin = chrono::steady_clock::now();
+	census.run(soups - warmup);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	allocations = getAllocationCount() - allocations;
+
+	cout << census.getSoups() << " soups of " << ruleString(rule) << " from seed " << seed << ", "
+		<< ThreadPool::shared().getThreads() << " threads" << endl;
+	if (soups > warmup)
+		cout << fixed << setprecision(1) << (soups - warmup) / seconds << " soups/s, "
+			<< setprecision(2) << (double)allocations / (soups - warmup) << " allocations per soup" << endl;
+	cout << census.getUnfinished() << " soups did not settle within " << Census::MAX_GENERATIONS << " generations" << endl;
+	cout << right << setw(12) << "count" << "  " << left << setw(14) << "kind" << right << setw(8) << "period"
+		<< setw(10) << "speed" << setw(8) << "cells" << setw(12) << "first soup" << "  hash" << endl;
+	for (auto& entry : census.getTable())
+	{
+		string speed = (entry.kind == SPACESHIP) ? to_string(entry.dx) + "," + to_string(entry.dy) : "";
+		cout << right << setw(12) << entry.count << "  " << left << setw(14) << objectKindName(entry.kind) << right
+			<< setw(8) << entry.period << setw(10) << speed << setw(8) << entry.population << setw(12) << entry.firstSoup
+			<< "  " << hex << setw(16) << setfill('0') << entry.hash << dec << setfill(' ') << endl;
+	}
+	return 0;
+}
+
+//saves a soup of a census, so an object from the table can be looked at on the board it came from
+static int soup(int argc, char** args)
+{
+	if (argc < 5)
+		throw "--soup needs a seed, a soup number and a file";
+	Board board(false, Census::BOARD_SIZE, Census::BOARD_SIZE);
+	Census::makeSoup(board, Census::soupSeed(strtoull(args[2], nullptr, 10), atoll(args[3])));
+	board.saveState(args[4]);
+	return 0;
+}
+
+/* runs every collision of two or more patterns and prints what they leave, the most common
+ * first. With --target only the outcomes that are the target's objects (or nothing at all,
+ * for empty) are printed, and --save writes an example of each printed outcome to a .brd file.
+ */
+static int collide(int argc, char** args)
+{
+	vector<string> files;
+	string target, prefix;
+	int generations = 256;
+	for (int i = 2; i < argc; i++)
+	{
+		string arg = args[i];
+		if ((arg == "--target" || arg == "--gens" || arg == "--save") && i + 1 == argc)
+			throw "--collide needs a value after --target, --gens and --save";
+		if (arg == "--target")
+			target = args[++i];
+		else if (arg == "--gens")
+			generations = atoi(args[++i]);
+		else if (arg == "--save")
+			prefix = args[++i];
+		else
+			files.push_back(arg);
+	}
+
+	CollisionSearch search(files, generations);
+	vector<uint64_t> wanted;
+	if (!target.empty() && target != "empty")
+	{
+		Board board(target);
+		wanted = search.objectHashes(board);
+	}
+	auto begin = chrono::steady_clock::now();
+	vector<CollisionResult> outcomes = search.run();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+	cout << search.getCollisions() << " collisions on " << search.getHeight() << "x" << search.getWidth()
+		<< " boards, " << ThreadPool::shared().getThreads() << " threads" << endl;
+	cout << fixed << setprecision(1) << search.getCollisions() / seconds << " collisions/s, "
+		<< outcomes.size() << " different outcomes" << endl;
+	int saved = 0;
+	for (auto& outcome : outcomes)
+	{
+		if (!target.empty())
+		{
+			vector<uint64_t> hashes;
+			for (auto& object : outcome.objects)
+				hashes.push_back(object.hash);
+			if (outcome.edge || hashes != wanted)
+				continue;
+		}
+		cout << right << setw(10) << outcome.count << "  " << hex << setw(16) << setfill('0') << outcome.hash
+			<< dec << setfill(' ') << "  " << search.describe(outcome) << endl;
+		cout << setw(12) << "" << "eg " << search.describe(outcome.example) << endl;
+		if (!prefix.empty())
+		{
+			Board board(false, search.getHeight(), search.getWidth());
+			search.makeCollision(outcome.example, board);
+			board.saveState(prefix + to_string(saved++) + ".brd");
+		}
+	}
+	return 0;
+}
+
+/* brings the pattern library of saved/ up to date and lists its patterns (or the ones that
+ * match the text) with their size, rule, population and hash. Patterns with the same hash
+ * are the same cells, however they were turned or moved.
+ */
+static int library(int argc, char** args)
+{
+	PatternLibrary library("saved");
+	auto begin = chrono::steady_clock::now();
+	int indexed = library.refresh();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	const vector<LibraryEntry>& entries = library.getEntries();
+	vector<int> matches = library.search((argc > 2) ? args[2] : "");
+	for (int i : matches)
+	{
+		const LibraryEntry& entry = entries[i];
+		string size = to_string(entry.width) + "x" + to_string(entry.height);
+		cout << left << setw(40) << entry.name << right << setw(14) << size << "  " << left << setw(12) << entry.rule
+			<< right << setw(10) << ((entry.population < 0) ? string("?") : to_string(entry.population)) << "  " << hex
+			<< setw(16) << setfill('0') << entry.hash << dec << setfill(' ') << "  " << entry.error << endl;
+	}
+	cout << matches.size() << " of " << entries.size() << " patterns, " << indexed << " indexed in " << fixed
+		<< setprecision(2) << seconds << "s" << endl;
+	return 0;
+}
+
+//runs a command given on the command line without opening a window
+int runConsole(int argc, char** args)
+{
+	string command = args[1];
+	try
+	{
+		if (command == "--bench")
+			return bench(argc, args);
+		if (command == "--run")
+			return run(argc, args);
+		if (command == "--classify")
+			return classify(argc, args);
+		if (command == "--batch")
+			return batch(argc, args);
+		if (command == "--census")
+			return census(argc, args);
+		if (command == "--soup")
+			return soup(argc, args);
+		if (command == "--collide")
+			return collide(argc, args);
+		if (command == "--library")
+			return library(argc, args);
+	}
+	catch (const char * error)
+	{
+		cout << error << endl;
+		return 1;
+	}
+	printUsage();
+	return (command == "--help") ? 0 : 1;
+}
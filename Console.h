@@ -0,0 +1,10 @@
+//Header file for the console commands
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+/* runs a command given on the command line (for example --bench) without opening
+ * a window, and returns the exit code for main()
+ */
+int runConsole(int argc, char** args);
+
+#endif /* CONSOLE_H_ */
@@ -1,4 +1,5 @@
 #include "Controller.h"
+#include <algorithm>
 #include <exception>
 #include <sstream>
 #include <stdexcept>
@@ -82,6 +83,7 @@ Controller::~Controller()
 		delete board;
 		board = nullptr;
 	}
+	delete library;
 	SDL_DestroyRenderer(mainRenderer);
 }
 
@@ -94,7 +96,8 @@ void Controller::createNewBoard(bool wrapAround, int height, int width)
         delete board;
         board = nullptr;
     }
-	board = new Board(wrapAround, height, width);
+	board = makeEngine(engine, wrapAround, height, width);
+	boardEngine = engine;
 
 	//TODO: handle crazy large boards
 	resetZoom();
@@ -112,7 +115,8 @@ void Controller::createNewBoard(std::string filename)
         board = NULL;
     }
     //May throw an error if the file does not exist
-    board = new Board("saved" + separator() + filename);
+    board = makeEngine(engine, "saved" + separator() + filename);
+	boardEngine = engine;
 	resetZoom();
 	clearScreen();
 	renderStatusPanel();
@@ -149,6 +153,12 @@ controlState Controller::getState()
     return state;
 }
 
+//returns the engine new boards are made with
+engineType Controller::getEngine()
+{
+	return engine;
+}
+
 std::string Controller::getStateName()
 {
     switch(state)
@@ -265,6 +275,7 @@ void Controller::getKeybindingsBox()
 					"\nSpacebar\tToggle Cell"
 					"\nLeft-Click\tToggle Cell"
 					"\nEnter/Return\tPerform One Iteration"
+					"\nG\tJump to Generation"
 					"\n] (Right Bracket)\tIncrease Speed"
 					"\n[ (Left Bracket)\tDecrease Speed"
 					"\nLeft-Click\tToggle Cell"
@@ -474,6 +485,119 @@ int Controller::getIntInput(std::string message)
 	return result;
 }
 
+/* lets the user pick a pattern of saved/ from the library, returns its file name or "" if none was picked
+Typing narrows the list down to the patterns whose name, rule or comments contain the text,
+the arrow and page keys move the selection, Enter picks it and Escape gives up. Only the
+files changed since the last time are loaded, so the list opens at once.*/
+std::string Controller::browseLibrary()
+{
+	const int pageRows = 15;
+	if (library == nullptr)
+		library = new PatternLibrary("saved");
+	clearScreen();
+	GridBox indexing(mainRenderer, mainFont, "Indexing patterns...", mainColor, bgColor);
+	indexing.render(mainRenderer, boardPanel.w / 2, boardPanel.h / 2, true, CENTER);
+	updateScreen();
+	library->refresh();
+
+	const std::vector<LibraryEntry>& entries = library->getEntries();
+	std::string filter = "";
+	std::vector<int> matches = library->search(filter);
+	int selected = 0;
+	std::string picked = "";
+	bool quit = false;
+	bool updateRender = true;
+	SDL_StartTextInput();
+	while (!quit)
+	{
+		while (SDL_PollEvent(&event) != 0)
+		{
+			if (event.type == SDL_QUIT)
+			{
+				//nothing is picked, and the main loop stops once the menu returns
+				setState(EXITING);
+				quit = true;
+				break;
+			}
+			else if (event.type == SDL_KEYDOWN)
+			{
+				switch (event.key.keysym.sym)
+				{
+					case SDLK_ESCAPE:
+						quit = true;
+						break;
+					case SDLK_RETURN:
+						if (!matches.empty())
+							picked = entries[matches[selected]].name;
+						quit = true;
+						break;
+					case SDLK_UP:
+						selected--;
+						break;
+					case SDLK_DOWN:
+						selected++;
+						break;
+					case SDLK_PAGEUP:
+						selected -= pageRows;
+						break;
+					case SDLK_PAGEDOWN:
+						selected += pageRows;
+						break;
+					case SDLK_BACKSPACE:
+						if (!filter.empty())
+						{
+							filter.pop_back();
+							matches = library->search(filter);
+							selected = 0;
+						}
+						break;
+				}
+				selected = std::max(0, std::min(selected, (int)matches.size() - 1));
+				updateRender = true;
+			}
+			else if (event.type == SDL_TEXTINPUT)
+			{
+				filter += event.text.text;
+				matches = library->search(filter);
+				selected = 0;
+				updateRender = true;
+			}
+		}
+		if (updateRender)
+		{
+			//SDL_ttf cannot render empty strings, so blank cells are a space
+			std::vector<std::vector<std::string>> rows;
+			rows.push_back({"Search: " + filter + "_", std::to_string(matches.size()) + " of " + std::to_string(entries.size()), " ", " "});
+			rows.push_back({"Name", "Size", "Rule", "Cells"});
+			int first = selected / pageRows * pageRows;
+			for (int i = first; i < first + pageRows && i < (int)matches.size(); i++)
+			{
+				const LibraryEntry& entry = entries[matches[i]];
+				rows.push_back({(i == selected ? "> " : "  ") + entry.name, std::to_string(entry.width) + "x" + std::to_string(entry.height),
+					entry.rule.empty() ? " " : entry.rule, entry.population < 0 ? "?" : std::to_string(entry.population)});
+			}
+			//a few comments of the selected pattern, or why it cannot be loaded
+			if (!matches.empty())
+			{
+				const LibraryEntry& entry = entries[matches[selected]];
+				if (!entry.error.empty())
+					rows.push_back({entry.error});
+				for (size_t i = 0; i < entry.comments.size() && i < 3; i++)
+					rows.push_back({entry.comments[i].empty() ? " " : entry.comments[i]});
+			}
+			clearScreen();
+			GridBox list(mainRenderer, mainFont, rows, mainColor, bgColor);
+			list.render(mainRenderer, 0, 0, false, LEFT);
+			updateScreen();
+			updateRender = false;
+		}
+	}
+	SDL_StopTextInput();
+	return picked;
+}
+
+static const long long LARGE_BOARD_CELLS = 1 << 22;	//boards with this many cells are saved as .brd2 unless another format is asked for
+
 void Controller::saveCurrent()
 {
 	bool shouldSave = getYesOrNo("Would you like to save?");
@@ -494,12 +618,60 @@ void Controller::saveCurrent()
         {
             filename = "saved" + separator() + filename;
         }
-		if (!endsWith(filename, ".brd"))
+		//HashLife saves the whole universe as a .mc file or the area looked at as a .brd file, the sparse plane only saves .brd files
+		if (boardEngine == HASHLIFE_ENGINE && !endsWith(filename, ".mc") && !endsWith(filename, ".brd"))
+			filename += ".mc";
+		else if (boardEngine == SPARSE_ENGINE && !endsWith(filename, ".brd"))
 			filename += ".brd";
+		//.rle, .cells, .brd2 and .mc files are saved as such, anything else as a .brd file, or as a .brd2 file
+		//for big boards (a .brd file takes a byte a cell, a .brd2 file a bit and loads without being parsed)
+		else if (!endsWith(filename, ".brd") && !endsWith(filename, ".rle") && !endsWith(filename, ".cells") &&
+			!endsWith(filename, ".brd2") && !endsWith(filename, ".mc"))
+			filename += ((long long)board->getHeight() * board->getWidth() >= LARGE_BOARD_CELLS) ? ".brd2" : ".brd";
         board->saveState(filename);
     }
 }
 
+//asks for a generation and runs the board on to it without drawing every generation on the way
+//the board and the status panel are drawn after each slice of the jump, and ESC stops it there
+void Controller::jumpToGeneration()
+{
+	long long generation = getIntInput("Jump to which generation?");
+	jumpTarget = generation;
+	auto progress = [&](long long iterations)
+	{
+		bool keepGoing = true;
+		while (SDL_PollEvent(&event) != 0)
+		{
+			if (event.type == SDL_QUIT)
+			{
+				//the jump stops here, and pausedMode() returns to the main loop to end the program
+				setState(EXITING);
+				keepGoing = false;
+			}
+			else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)
+			{
+				keepGoing = false;
+			}
+		}
+		clearScreen();
+		renderBoard();
+		renderStatusPanel();
+		updateScreen();
+		return keepGoing;
+	};
+	try
+	{
+		board->jumpTo(generation, progress);
+	}
+	catch (char const* message)
+	{
+		getConfirmationBox(message);
+	}
+	jumpTarget = 0;
+	clearScreen();
+}
+
 void Controller::setState(controlState newState)
 {
     state = newState;
@@ -545,6 +717,12 @@ void Controller::setSpeed(int newSpeed)
     speed += newSpeed;
 }
 
+//chooses the engine new boards are made with, the board there is keeps its own
+void Controller::setEngine(engineType type)
+{
+	engine = type;
+}
+
 
 
 void Controller::setPan(int x, int y)
@@ -736,7 +914,6 @@ void Controller::clearScreen()
 void Controller::renderBoard(SDL_Rect * renderArea)
 {
 	std::cerr << "render board called\n";
-	std::vector<std::vector<bool>> matrix = board->getMatrix();
 
 	//adjust the boundaries?
 	int minRow = (renderArea->y - boardPosition.y) / cellHeight;
@@ -751,6 +928,9 @@ void Controller::renderBoard(SDL_Rect * renderArea)
 	//changing the color
 	std::cerr << minRow << "," << maxRow << ";" << minCol << "," << maxCol << std::endl;
 	SDL_SetRenderDrawColor(mainRenderer, mainColor.r, mainColor.g, mainColor.b, mainColor.a);
+	//dying cells of a Generations rule fade from the main colour to the background, one step per state
+	int states = stateCount(board->getRule());
+	int drawnState = 1;
 	int cellCount = 0, totalCount = 0;
 	for (int row = minRow; row < maxRow; row++)
 	{
@@ -767,11 +947,20 @@ void Controller::renderBoard(SDL_Rect * renderArea)
 				SDL_SetRenderDrawColor(mainRenderer, accentColor.r, accentColor.g, accentColor.b, 0xFF);
 				SDL_RenderFillRect(mainRenderer, &cellRect);
 			}*/
-			if (!matrix[row][column])
+			int state = board->getState(row, column);
+			if (state == 0)
 			{
 				totalCount++;
 				continue;
 			}
+			if (state != drawnState)
+			{
+				int fade = states - state;
+				SDL_SetRenderDrawColor(mainRenderer, bgColor.r + (mainColor.r - bgColor.r) * fade / (states - 1),
+					bgColor.g + (mainColor.g - bgColor.g) * fade / (states - 1),
+					bgColor.b + (mainColor.b - bgColor.b) * fade / (states - 1), 0xFF);
+				drawnState = state;
+			}
 			int borderSize = 1;
 			if (borderSize > 0)
 			{
@@ -843,6 +1032,8 @@ void Controller::renderStatusPanel(SDL_Rect * renderArea)
 	//creating string streams for board size and status
 	boardSize << "Size: " << board->getHeight() << "x" << board->getWidth();
 	status << "Status: " << getStateName();
+	if (jumpTarget > 0)
+		status << " (jumping to " << jumpTarget << ", ESC to stop)";
 	//adding strings to stringList
 	stringList.push_back(boardSize.str());
 	stringList.push_back(status.str());
@@ -852,12 +1043,16 @@ void Controller::renderStatusPanel(SDL_Rect * renderArea)
 	{
 		std::ostringstream iterations, births, deaths, speed;
 		iterations << "Iterations: " << board->getIterations();
-		births << "Births: " << board->getBirths();
-		deaths << "Deaths: " << board->getDeaths();
 		speed << "Speed: " << this->speed;
 		stringList.push_back(iterations.str());
-		stringList.push_back(births.str());
-		stringList.push_back(deaths.str());
+		//HashLife does not count births and deaths
+		if (board->getBirths() >= 0)
+		{
+			births << "Births: " << board->getBirths();
+			deaths << "Deaths: " << board->getDeaths();
+			stringList.push_back(births.str());
+			stringList.push_back(deaths.str());
+		}
 		stringList.push_back(speed.str());
 	}
 
@@ -889,7 +1084,7 @@ void Controller::renderStatusPanel()
 	renderStatusPanel(&statusPanel);
 }
 
-void Controller::renderPattern(std::vector<std::vector<bool>>& matrix, SDL_Rect * renderArea)
+void Controller::renderPattern(const std::vector<std::vector<bool>>& matrix, SDL_Rect * renderArea)
 {
 	SDL_SetRenderDrawColor(mainRenderer, accentColor.r, accentColor.g, accentColor.b, 0x7F);
 	for (int row = 0; row < matrix.size(); row++)
@@ -1142,6 +1337,11 @@ void Controller::pausedMode()
 						getKeybindingsBox();
 						break;
 
+					case SDLK_g:
+						jumpToGeneration();
+						doRenderUpdate = true;
+						break;
+
 					case SDLK_a:
 					{
 						std::string patternFilename = getStringInput("Enter pattern name.");
@@ -6,7 +6,9 @@
 #include "TextBox.h"
 #include "GridBox.h"
 #include "Board.h"
+#include "Engine.h"
 #include "Formats.h"
+#include "Library.h"
 #include "Pattern.h"
 #include "Util.h"
 
@@ -36,7 +38,9 @@ private:
 class Controller
 {
 
-    Board * board = NULL;
+    Engine * board = NULL;
+	engineType engine = BOARD_ENGINE;	//the engine new boards are made with
+	engineType boardEngine = BOARD_ENGINE;	//the engine the board was made with
 
     /*Speed is the frequency of iterations, in iterations/s.
     The system processes this as the period of iterations, or the delay between
@@ -62,6 +66,9 @@ class Controller
 	int currentRow = 0;
 	int currentCol = 0;
 
+	long long jumpTarget = 0;	//the generation a jump is running to, 0 when there is none
+	PatternLibrary * library = nullptr;	//the index of saved/, made the first time the library is browsed
+
 	int cellWidth = 2;
 	int cellHeight = 2;
 
@@ -77,7 +84,7 @@ class Controller
 		void checkRC();
 		void renderBoard(SDL_Rect * renderArea);
 		void renderStatusPanel(SDL_Rect * renderArea);
-        void renderPattern(std::vector<std::vector<bool>>& matrix, SDL_Rect * renderArea);
+        void renderPattern(const std::vector<std::vector<bool>>& matrix, SDL_Rect * renderArea);
 
 	public:
 		//constructors and destructors
@@ -97,6 +104,7 @@ class Controller
         int getSpeed();
         controlState getState();
         std::string getStateName();
+		engineType getEngine();
 
 		//USER INTERFACE METHODS
 		//present users with buttons
@@ -109,11 +117,14 @@ class Controller
 		double getRatioInput(std::string message);
 		int getIntInput(std::string message);
 		void saveCurrent();
+		std::string browseLibrary();
+		void jumpToGeneration();
 
 		//MUTATOR METHODS
 		//control the state / speed of the controller
         void setState(controlState newState);
         void setSpeed(int newSpeed);
+		void setEngine(engineType type);
 		//control the "camera"
 		void setPan(int x, int y);
 		void setZoom(int amount);
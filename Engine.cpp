@@ -0,0 +1,104 @@
+#include "Engine.h"
+#include "Board.h"
+#include "HashLife.h"
+#include "SparsePlane.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+
+//toggles each cell of the board with the given chance
+void Engine::randomize(double ratio)
+{
+	ratio = (ratio < 0) ? 0 : ratio;
+	ratio = (ratio > 1) ? 1 : ratio;
+	for (int r = 0; r < getHeight(); r++)
+	{
+		for (int c = 0; c < getWidth(); c++)
+		{
+			if (((double)rand()/RAND_MAX) <= ratio)
+			{
+				toggle(r, c);
+			}
+		}
+	}
+}
+
+//sets the cells of the pattern with its top left corner on row y and column x, wrapping around the edges of the board
+void Engine::addPattern(vector<vector<bool>> patternMatrix, int y, int x)
+{
+	for(size_t i = 0; i < patternMatrix.size(); i++)
+	{
+		for(size_t j = 0; j < patternMatrix[0].size(); j++)
+		{
+			toggle((y + i) % getHeight(), (x + j) % getWidth(), patternMatrix[i][j]);
+		}
+	}
+}
+
+/*runs on to the given generation, returns false if progress cancelled the jump
+Nothing is drawn on the way. The jump runs in slices that double in length until one takes
+about a tenth of a second, and progress is called after each of them, often enough to show
+how far the jump got and to cancel it, too seldom to slow it down.*/
+bool Engine::jumpTo(long long generation, bool (*progress)(void*, long long), void * context)
+{
+	if (generation < getIterations())
+		throw "The board is already past that generation";
+	long long slice = 1;
+	while (getIterations() < generation)
+	{
+		auto begin = chrono::steady_clock::now();
+		runIteration(min(slice, generation - getIterations()));
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		if (seconds < 0.05)
+			slice *= 2;
+		else if (seconds > 0.2 && slice > 1)
+			slice /= 2;
+		if (progress != nullptr && !progress(context, getIterations()))
+			return false;
+	}
+	return true;
+}
+
+//an empty board of the given engine, HashLife and the sparse plane are unbounded and ignore wrapAround
+Engine * makeEngine(engineType type, bool wrapAround, int height, int width)
+{
+	switch (type)
+	{
+		case HASHLIFE_ENGINE:
+			return new HashLife(height, width);
+		case SPARSE_ENGINE:
+			return new SparsePlane(height, width);
+		default:
+			return new Board(wrapAround, height, width);
+	}
+}
+
+//loads a file into the given engine, throws like the engine's constructor if it cannot
+Engine * makeEngine(engineType type, string filename)
+{
+	switch (type)
+	{
+		case HASHLIFE_ENGINE:
+			return new HashLife(filename);
+		case SPARSE_ENGINE:
+			return new SparsePlane(filename);
+		default:
+			return new Board(filename);
+	}
+}
+
+//returns "Board", "HashLife" or "Sparse plane"
+string engineName(engineType type)
+{
+	switch (type)
+	{
+		case HASHLIFE_ENGINE:
+			return "HashLife";
+		case SPARSE_ENGINE:
+			return "Sparse plane";
+		default:
+			return "Board";
+	}
+}
@@ -0,0 +1,60 @@
+//Header file for the engine interface
+#ifndef ENGINE_H_
+#define ENGINE_H_
+
+#include <string>
+#include <vector>
+#include "Rule.h"
+
+enum engineType {BOARD_ENGINE, HASHLIFE_ENGINE, SPARSE_ENGINE};	//which class makeEngine() makes: Board, HashLife or SparsePlane
+
+/* the load/step/query surface every simulation engine offers. An engine is loaded by
+ * its constructor (from a file or as an empty board of a given size), stepped with
+ * runIteration() and read back one cell at a time, so code written against Engine
+ * works with the packed Board as well as with HashLife.
+ */
+class Engine
+{
+	template <typename PROGRESS>
+	static bool progressTrampoline(void * progress, long long iterations)
+	{
+		return (*(PROGRESS*)progress)(iterations);
+	}
+
+protected:
+	virtual bool jumpTo(long long generation, bool (*progress)(void*, long long), void * context);	//jumpTo() with the progress callback and its context
+
+public:
+	virtual ~Engine() {}
+
+	virtual void toggle(int r, int c) = 0;					//toggles the cell from true to false or false to true
+	virtual void toggle(int r, int c, bool living) = 0;		//sets the cell to living
+	virtual void randomize(double ratio=0.5);				//toggles each cell of the board with the given chance
+	virtual void addPattern(std::vector<std::vector<bool>> patternMatrix, int y, int x);	//sets the cells of the pattern with its top left corner on row y and column x
+	virtual void runIteration() = 0;						//runs one iteration
+	virtual void runIteration(long long runs) = 0;			//runs the given number of iterations
+	virtual void saveState(std::string fileName) = 0;		//save the board as a .brd file
+	virtual void setRule(const Rule& rule) = 0;				//changes the birth and survival rule
+	virtual Rule getRule() = 0;								//returns the birth and survival rule
+	virtual bool getCell(int r, int c) = 0;					//returns true if the cell is alive
+	virtual int getState(int r, int c) { return getCell(r, c) ? 1 : 0; }	//returns 0 for dead cells, 1 for live ones and 2 and up for dying ones
+	virtual int getHeight() = 0;							//returns the height of the board
+	virtual int getWidth() = 0;								//returns the width of the board
+	virtual long long getIterations() = 0;					//returns the number of iterations that were run
+	virtual long long getBirths() { return -1; }			//returns the number of births that occurred, -1 if the engine does not count them
+	virtual long long getDeaths() { return -1; }			//returns the number of deaths that occurred, -1 if the engine does not count them
+	virtual long long getPopulation() = 0;					//returns the number of live cells
+
+	//runs on to the given generation calling progress(iterations) after every slice of the jump, returning false from it cancels the jump where it is
+	template <typename PROGRESS>
+	bool jumpTo(long long generation, PROGRESS& progress)
+	{
+		return jumpTo(generation, &Engine::progressTrampoline<PROGRESS>, (void*)&progress);
+	}
+};
+
+Engine * makeEngine(engineType type, bool wrapAround, int height, int width);	//an empty board of the given engine (only a Board wraps around)
+Engine * makeEngine(engineType type, std::string filename);					//loads a file into the given engine
+std::string engineName(engineType type);										//returns "Board", "HashLife" or "Sparse plane"
+
+#endif /* ENGINE_H_ */
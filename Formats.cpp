@@ -1,4 +1,95 @@
 #include "Formats.h"
+#include "Macrocell.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#if defined WIN32 || defined _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//maps the whole file, throws if it cannot be opened
+MappedFile::MappedFile(string filename)
+{
+	data = nullptr;
+	size = 0;
+	file = nullptr;
+	mapping = nullptr;
+#if defined WIN32 || defined _WIN32
+	HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		throw "Error Opening File";
+	file = handle;
+	LARGE_INTEGER length;
+	GetFileSizeEx(handle, &length);
+	size = length.QuadPart;
+	if (size == 0)
+		return;
+	mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(handle);
+		throw "Error Opening File";
+	}
+	data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int handle = open(filename.c_str(), O_RDONLY);
+	if (handle < 0)
+		throw "Error Opening File";
+	struct stat info;
+	if (fstat(handle, &info) != 0 || !S_ISREG(info.st_mode))
+	{
+		close(handle);
+		throw "Error Opening File";
+	}
+	size = info.st_size;
+	if (size > 0)
+	{
+		void * view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0);
+		data = (view == MAP_FAILED) ? nullptr : (const char *)view;
+#ifdef MADV_SEQUENTIAL
+		if (data != nullptr)
+			madvise(view, size, MADV_SEQUENTIAL);
+#endif
+	}
+	//the mapping stays valid once the file is closed
+	close(handle);
+	if (size > 0 && data == nullptr)
+		throw "Error Opening File";
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined WIN32 || defined _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mapping != nullptr)
+		CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	if (data != nullptr)
+		munmap((void *)data, size);
+#endif
+}
+
+//returns the first byte of the file
+const char * MappedFile::begin()
+{
+	return data;
+}
+
+//returns one past the last byte of the file
+const char * MappedFile::end()
+{
+	return data + size;
+}
+
 
 BoardData loadLife(string filename)
 {
@@ -19,10 +110,13 @@ BoardData loadLife(string filename)
 	vector<coords> toggleList;
 	int width = 0, height = 0;
 	int x = 0, y = 0;
-	char birthBuf[11];
-	char survivalBuf[11];
 	set<int> birthRule = {3,};
 	set<int> survivalRule = {2, 3,};
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	Topology topology = TORUS;
 
 
 	while(getline(in, line))
@@ -32,12 +126,11 @@ BoardData loadLife(string filename)
 			continue;
 
 		// handle rule lines
-		if(startsWith(line, "#R "))
+		if(line.compare(0, 3, "#R ") == 0)
 		{
-			if(sscanf(line.c_str(), "#R %10s/%10s", birthBuf, survivalBuf) != 2)
+			if(!string2rule(line.substr(3), birthRule, survivalRule, range, neighbourhood, states, transitions) ||
+				!string2topology(line.substr(3), topology))
 				throw "Error Parsing Rules";
-			birthRule = rule2set(birthBuf);
-			survivalRule = rule2set(survivalBuf);
 		}
 
 		// skip all other comment lines
@@ -83,8 +176,9 @@ BoardData loadLife(string filename)
 	in.close();
 	// apply the data set
 	BoardData ret = {true, height, width, 0, 0, 0,
-		birthRule, survivalRule,
+		birthRule, survivalRule, range, neighbourhood, states, transitions,
 		vector<vector<bool>>(height, vector<bool> (width, 0))};
+	ret.topology = topology;
 	//for(int i = 0; i < (int)toggleList.size(); i++)
 	for(auto coord : toggleList)
 		ret.matrix[coord.y][coord.x] = true;
@@ -94,107 +188,260 @@ BoardData loadLife(string filename)
 
 }
 
-BoardData loadRLE(string filename)
+//what one stretch of an RLE body holds, see loadRLE()
+struct RLEChunk
 {
-	ifstream in;
-	in.open(filename);
-
-	if (!in.is_open())
-		throw "Error Opening File";
-
-	string line;
-	int width = 0, height = 0;
-
-	// skip comments
-	while (getline(in, line))
-		if (line.at(0) == '#')
+	const char * begin;		//first byte of the stretch, at the start of a row
+	const char * end;		//one past its last byte
+	long long rows;			//rows the stretch moves down
+	long long top;			//the row the stretch starts on
+	bool ended;				//true if the stretch has the '!' that ends the pattern
+	bool states;			//true if the stretch has dying states (Generations rules)
+};
+
+/* walks the runs of a stretch of an RLE body that starts at the beginning of row y, calling
+ * run(x, y, count, state) for every run of cells that are not dead, cut down to the height
+ * and width. Returns the number of rows the stretch moves down; ended is set if it stops at
+ * the '!' that ends the pattern. Like the old line by line loader, a '#' starts a comment
+ * that lasts to the end of the line and a number can be split over two lines.
+ */
+template <typename RUN>
+static long long scanRLE(const char * p, const char * end, long long y, long long height, long long width, int states,
+	bool& ended, RUN run)
+{
+	const long long first = y;
+	long long x = 0, count = 0;
+	int prefix = 0;
+	ended = false;
+	for (; p < end; p++)
+	{
+		char c = *p;
+		if (c == '#')
+		{
+			while (p + 1 < end && p[1] != '\n')
+				p++;
 			continue;
-		else
+		}
+		if (c == '\n' || c == '\r' || c == ' ' || c == '\t')
+			continue;
+		if ('0' <= c && c <= '9')
+		{
+			count = count * 10 + (c - '0');
+			continue;
+		}
+		if (c == '$')
+		{
+			y += (count > 0) ? count : 1;
+			x = 0;
+			count = 0;
+			continue;
+		}
+		if (c == '!')
+		{
+			ended = true;
 			break;
-
-	string rules;
-	char birthBuf[11];
-	char survivalBuf[11];
-	set<int> birthRule;
-	set<int> survivalRule;
-
-	// detected rule string
-	// %*1s is a cheap way to discard the prefix chars [bBsS]
-	if(sscanf(line.c_str(), "x = %d, y = %d, rule = %*1s%10s/%*1s%10s",
-		&width, &height, birthBuf, survivalBuf) == 4)
-	{
-		birthRule = rule2set(birthBuf);
-		survivalRule = rule2set(survivalBuf);
+		}
+		// a letter from p to y is the first half of a state above 24
+		if ('p' <= c && c <= 'y')
+		{
+			prefix = c - 'p' + 1;
+			continue;
+		}
+		// b or . is dead, o is alive, A to X are states 1 to 24, states the rule does not have are dead
+		int state = (c == 'o') ? 1 : 0;
+		if ('A' <= c && c <= 'X')
+			state = prefix * 24 + (c - 'A' + 1);
+		prefix = 0;
+		state = (state < states) ? state : 0;
+		if (count == 0)
+			count = 1;
+		// cells outside the declared size are dropped
+		if (state > 0 && y < height && x < width)
+			run(x, y, min(count, width - x), state);
+		x += count;
+		count = 0;
 	}
-	// no rule string, use defaults
-	else
+	return y - first;
+}
+
+//sets bits [x, x + count) of a packed row
+static void setRun(uint64_t * row, long long x, long long count)
+{
+	const long long last = x + count;
+	while (x < last)
 	{
-		sscanf(line.c_str(), "x = %d, y = %d%*s", &width, &height);
-		birthRule = {3,};
-		survivalRule = {2, 3,};
+		int bit = x & 63;
+		long long take = min(64LL - bit, last - x);
+		row[x >> 6] |= (take == 64) ? ~(uint64_t)0 : (((uint64_t)1 << take) - 1) << bit;
+		x += take;
 	}
+}
 
-	BoardData ret = {true, height, width, 0, 0, 0,
-		birthRule, survivalRule,
-		vector<vector<bool>>(height, vector<bool> (width, 0))};
-	int x = 0, y = 0;
-	int count = 0;
-	bool quit = false;
-	while (getline(in, line) && !quit)
+/* returns the number of rows a stretch of an RLE body moves down, setting ended if it has the '!'
+ * This is scanRLE() without decoding anything: memchr() finds the '$'s and only the number in
+ * front of each is read. Stretches with comments or dying states are left to scanRLE().
+ */
+static long long countRows(const char * begin, const char * end, bool& ended)
+{
+	const char * stop = (const char *)memchr(begin, '!', end - begin);
+	ended = stop != nullptr;
+	if (ended)
+		end = stop;
+	long long rows = 0;
+	for (const char * p = begin; (p = (const char *)memchr(p, '$', end - p)) != nullptr; p++)
 	{
-		for (auto c : line)
+		// the number is read backwards, it can be split over two lines, and a state prefix (p to y) does not use it up
+		long long count = 0, digit = 1;
+		for (const char * q = p - 1; q >= begin; q--)
 		{
-			// found a comment, get the next line
-			if(c == '#')
-				break;
-			// handle newlines
-			if (c == '\n' || c == '\r')
-				continue;
-			// handle RLE number
-			if ('0' <= c && c <= '9')
+			if ('0' <= *q && *q <= '9')
 			{
-				count = count * 10 + (c - '0');
-				continue;
+				count += (*q - '0') * digit;
+				digit *= 10;
 			}
-
-			// handle board newline / quit chars
-			if (c == '$')
-			{
-				if (count > 0)
-					y += count;
-				else
-					y++;
-				x = 0;
-				count = 0;
-				continue;
-			}
-			if (c == '!')
+			else if (*q != '\n' && *q != '\r' && *q != ' ' && *q != '\t' && !('p' <= *q && *q <= 'y'))
 			{
-				quit = true;
 				break;
 			}
-
-			// apply the alive or dead cell
-			if (count)
-			{
-				for (int j = 0; j < count; j++)
-				{
-					if (c == 'o')
-						ret.matrix[y][x] = true;
-					x++;
-				}
-				count = 0;
-			}
-			else
-			{
-				if (c == 'o')
-					ret.matrix[y][x] = true;
-				x++;
-			}
 		}
+		rows += (count > 0) ? count : 1;
+	}
+	return rows;
+}
 
+//returns the byte after the first '$' at or after p that is not in a comment, or end; from is known to be outside one
+static const char * nextRow(const char * p, const char * from, const char * end)
+{
+	for (; p < end; p++)
+	{
+		if (*p != '$')
+			continue;
+		//a '#' earlier on the same line makes this a comment
+		const char * q = p;
+		while (q > from && q[-1] != '\n' && q[-1] != '#')
+			q--;
+		if (q == from || q[-1] == '\n')
+			return p + 1;
+		while (p < end && *p != '\n')
+			p++;
 	}
-	in.close();
+	return end;
+}
+
+/* loads an RLE file
+The file is mapped rather than read, and its cells go straight into packed rows (see
+BoardData::packed) rather than into a matrix that would be packed again. Big files are
+cut into stretches that start at the beginning of a row and decoded in two passes over
+every core: the first counts the rows each stretch moves down, which gives every stretch
+the row it starts on, and the second decodes them all at once. Every stretch writes its
+own rows, so they never touch the same word.*/
+BoardData loadRLE(string filename)
+{
+	MappedFile file(filename);
+	const char * p = file.begin();
+	const char * end = file.end();
+
+	// skip comments (and blank lines) up to the header line, the counters of a saved board are in a comment
+	string line;
+	long long iterations = 0, births = 0, deaths = 0;
+	while (p < end)
+	{
+		const char * eol = find(p, end, '\n');
+		line.assign(p, eol);
+		p = (eol < end) ? eol + 1 : end;
+		if (!line.empty() && line.at(0) != '#' && line.at(0) != '\r')
+			break;
+		sscanf(line.c_str(), "#C generation %lld, births %lld, deaths %lld", &iterations, &births, &deaths);
+		line.clear();
+	}
+
+	int width = 0, height = 0;
+	// no rule string means the default B3/S23
+	set<int> birthRule = {3,};
+	set<int> survivalRule = {2, 3,};
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	Topology topology = TORUS;
+	sscanf(line.c_str(), "x = %d, y = %d", &width, &height);
+	size_t rulePosition = line.find("rule");
+	if (rulePosition != string::npos)
+	{
+		size_t equals = line.find('=', rulePosition);
+		if (equals == string::npos || !string2rule(line.substr(equals + 1), birthRule, survivalRule, range, neighbourhood, states, transitions) ||
+			!string2topology(line.substr(equals + 1), topology))
+			throw "Error Parsing Rules";
+	}
+	width = max(width, 0);
+	height = max(height, 0);
+
+	BoardData ret = {true, height, width, iterations, births, deaths,
+		birthRule, survivalRule, range, neighbourhood, states, transitions,
+		vector<vector<bool>>()};
+	ret.topology = topology;
+	const size_t wordsPerRow = (width + 63) / 64;
+	ret.packed.assign(height * wordsPerRow, 0);
+
+	// below a megabyte a single stretch is quicker than waking the other threads
+	ThreadPool& pool = ThreadPool::shared();
+	const size_t length = end - p;
+	const int count = (length >= (1 << 20)) ? 4 * pool.getThreads() : 1;
+	vector<RLEChunk> chunks(count);
+	const char * from = p;
+	for (int i = 0; i < count; i++)
+	{
+		chunks[i].begin = from;
+		from = (i + 1 < count) ? nextRow(max(from, p + length * (i + 1) / count), from, end) : end;
+		chunks[i].end = from;
+	}
+
+	// first pass: the rows every stretch moves down
+	auto measure = [&](int i)
+	{
+		RLEChunk& chunk = chunks[i];
+		chunk.states = false;
+		if (states <= 2 && memchr(chunk.begin, '#', chunk.end - chunk.begin) == nullptr)
+		{
+			chunk.rows = countRows(chunk.begin, chunk.end, chunk.ended);
+			return;
+		}
+		auto run = [&](long long, long long, long long, int state)
+		{
+			chunk.states |= state > 1;
+		};
+		chunk.rows = scanRLE(chunk.begin, chunk.end, 0, LLONG_MAX, width, states, chunk.ended, run);
+	};
+	pool.run(measure, count);
+	long long top = 0;
+	int used = 0;
+	bool dying = false;
+	while (used < count)
+	{
+		chunks[used].top = top;
+		top += chunks[used].rows;
+		dying |= chunks[used].states;
+		if (chunks[used++].ended)
+			break;
+	}
+	if (dying)
+		ret.cellStates.assign(height, vector<unsigned char>(width, 0));
+
+	// second pass: every stretch decodes its own rows
+	auto decode = [&](int i)
+	{
+		RLEChunk& chunk = chunks[i];
+		auto run = [&](long long x, long long y, long long cells, int state)
+		{
+			if (state == 1)
+				setRun(&ret.packed[y * wordsPerRow], x, cells);
+			else
+				fill(ret.cellStates[y].begin() + x, ret.cellStates[y].begin() + x + cells, state);
+		};
+		bool ended;
+		scanRLE(chunk.begin, chunk.end, chunk.top, height, width, states, ended, run);
+	};
+	pool.run(decode, used);
 
 	return ret;
 }
@@ -213,34 +460,298 @@ BoardData loadBRD(string filename)
 	int height = fs_atoi(in);
 	int width = fs_atoi(in);
 	bool wrapAround = fs_atoi(in);
-	int iterations = fs_atoi(in);
-	int births = fs_atoi(in);
-	int deaths = fs_atoi(in);
-	set<int> birthRule;
-	set<int> survivalRule;
-
+	long long iterations = fs_atoll(in);
+	long long births = fs_atoll(in);
+	long long deaths = fs_atoll(in);
+	set<int> birthRule = {3,};
+	set<int> survivalRule = {2, 3,};
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	Topology topology = wrapAround ? TORUS : PLANE;
+
+	// newer files have a rule line (eg "B3/S23" or "R5,C0,M0,S33..57,B34..45,NM") before the matrix, older ones run B3/S23
+	bool haveLine = (bool)getline(in, line);
+	if(haveLine && !line.empty() && (toupper(line.at(0)) == 'B' || toupper(line.at(0)) == 'R'))
+	{
+		if(!string2rule(line, birthRule, survivalRule, range, neighbourhood, states, transitions) ||
+			!string2topology(line, topology))
+			throw "Error Parsing Rules";
+		haveLine = (bool)getline(in, line);
+	}
 
 	BoardData ret = {wrapAround, height, width, iterations,
-					births, deaths, birthRule, survivalRule,
+					births, deaths, birthRule, survivalRule, range, neighbourhood, states, transitions,
 					vector<vector<bool>>(height, vector<bool> (width, 0))};
+	ret.topology = topology;
 
 
 	int row = 0;
 
-	// read & apply the matrix
-	while(getline(in, line))
+	// read & apply the matrix, Generations boards write dying cells as '0' + state
+	if(states > 2)
+		ret.cellStates.assign(height, vector<unsigned char>(width, 0));
+	while(haveLine && row < height)
 	{
 		for(int i = 0; i <width; i++)
-			ret.matrix[row][i] = line.at(i) == '1';
+		{
+			int state = line.at(i) - '0';
+			ret.matrix[row][i] = state == 1;
+			if(state > 1 && state < states)
+				ret.cellStates[row][i] = state;
+		}
 		row++;
+		haveLine = (bool)getline(in, line);
 	}
 
 	in.close();
 	return ret;
 }
 
+/* loads a plaintext (.cells) file: a line of '.' (dead) and 'O' (alive) per row, and
+ * comment lines starting with '!'. Rows can be shorter than the widest one. The rule, size
+ * and counters of a saved board are read back from its comments, since the dead cells at
+ * the end of its rows are left out. Without a size the board is as wide as the widest row,
+ * and without a rule it is B3/S23.
+ */
+BoardData loadCells(string filename)
+{
+	MappedFile file(filename);
+	const char * p = file.begin();
+	const char * end = file.end();
+
+	set<int> birthRule = {3,};
+	set<int> survivalRule = {2, 3,};
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	Topology topology = TORUS;
+	long long iterations = 0, births = 0, deaths = 0;
+	vector<pair<const char *, const char *>> rows;
+	int width = 0;
+	int sizeWidth = 0, sizeHeight = 0;
+	string line;
+	while (p < end)
+	{
+		const char * eol = find(p, end, '\n');
+		const char * last = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+		if (p < last && *p == '!')
+		{
+			line.assign(p, last);
+			sscanf(line.c_str(), "!Generation %lld, births %lld, deaths %lld", &iterations, &births, &deaths);
+			int w, h;
+			if (sscanf(line.c_str(), "!Size %dx%d", &w, &h) == 2)
+			{
+				if (w < 0 || h < 0)
+					throw "Error: Invalid Board Size";
+				sizeWidth = w;
+				sizeHeight = h;
+			}
+			if (line.compare(0, 6, "!Rule ") == 0 && (!string2rule(line.substr(6), birthRule, survivalRule, range,
+				neighbourhood, states, transitions) || !string2topology(line.substr(6), topology)))
+				throw "Error Parsing Rules";
+		}
+		else
+		{
+			rows.push_back(make_pair(p, last));
+			width = max(width, (int)(last - p));
+		}
+		p = (eol < end) ? eol + 1 : end;
+	}
+
+	//a size too small for the rows (a file edited by hand) grows to fit them
+	const int height = max(sizeHeight, (int)rows.size());
+	width = max(width, sizeWidth);
+	BoardData ret = {true, height, width, iterations, births, deaths,
+		birthRule, survivalRule, range, neighbourhood, states, transitions,
+		vector<vector<bool>>()};
+	ret.topology = topology;
+	const size_t wordsPerRow = (width + 63) / 64;
+	ret.packed.assign((size_t)height * wordsPerRow, 0);
+	for (size_t r = 0; r < rows.size(); r++)
+		for (const char * c = rows[r].first; c < rows[r].second; c++)
+			if (*c == 'O' || *c == '*')
+			{
+				int x = c - rows[r].first;
+				ret.packed[r * wordsPerRow + (x >> 6)] |= (uint64_t)1 << (x & 63);
+			}
+	return ret;
+}
+
+/* the checksum of a multiple of 8 bytes, as .brd2 files use
+Four words are mixed at a time into four separate sums, so a gigacell board is checked
+about as fast as it can be read.*/
+uint64_t brd2Checksum(const void * data, size_t bytes, uint64_t seed)
+{
+	const uint64_t * words = (const uint64_t *)data;
+	const size_t count = bytes / 8;
+	uint64_t lanes[4] = {seed ^ 0x9e3779b97f4a7c15ULL, seed ^ 0xbf58476d1ce4e5b9ULL, seed ^ 0x94d049bb133111ebULL, seed + count};
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		for (int k = 0; k < 4; k++)
+			lanes[k] = (lanes[k] ^ words[i + k]) * 0xff51afd7ed558ccdULL + (lanes[k] >> 29);
+	for (; i < count; i++)
+		lanes[0] = (lanes[0] ^ words[i]) * 0xff51afd7ed558ccdULL + (lanes[0] >> 29);
+	uint64_t h = 0;
+	for (int k = 0; k < 4; k++)
+	{
+		h = (h ^ lanes[k]) * 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+	}
+	return h;
+}
+
+/* loads a .brd2 file (see BRD2Header)
+The file is mapped, its header and checksums are checked, and the cells are copied into
+the board's packed storage as they are, without being parsed. Dying states only turn up
+in Generations boards, they are unpacked into cellStates.*/
+BoardData loadBRD2(string filename)
+{
+	MappedFile file(filename);
+	const size_t size = file.end() - file.begin();
+	BRD2Header header;
+	if (size < sizeof(header))
+		throw "Error: Truncated .brd2 File";
+	memcpy(&header, file.begin(), sizeof(header));
+	if (memcmp(header.magic, BRD2_MAGIC, sizeof(BRD2_MAGIC)) != 0)
+		throw "Error: Not a .brd2 File";
+	if (header.version != BRD2_VERSION)
+		throw "Error: Unknown .brd2 Version";
+	const size_t wordsPerRow = (header.width + 63) / 64;
+	const size_t words = (size_t)header.height * wordsPerRow;
+	if (header.headerSize % 8 != 0 || header.headerSize < sizeof(header) + header.ruleLength || header.planes < 1 ||
+		header.planes > 8 || size < header.headerSize || size - header.headerSize != words * header.planes * 8)
+		throw "Error: Truncated .brd2 File";
+	const uint64_t stored = header.headerChecksum;
+	header.headerChecksum = 0;
+	uint64_t checksum = brd2Checksum(&header, sizeof(header));
+	checksum = brd2Checksum(file.begin() + sizeof(header), header.headerSize - sizeof(header), checksum);
+	if (checksum != stored)
+		throw "Error: Bad .brd2 Header Checksum";
+	const uint64_t * rows = (const uint64_t *)(file.begin() + header.headerSize);
+	checksum = 0;
+	for (size_t k = 0; k < header.planes; k++)
+		checksum = brd2Checksum(rows + k * words, words * 8, checksum);
+	if (checksum != header.dataChecksum)
+		throw "Error: Bad .brd2 Checksum";
+	//no plane may have cells past the width in the last word of a row, the board keeps them zero
+	const uint64_t tail = (header.width % 64) ? ~0ULL << (header.width % 64) : 0;
+	if (tail)
+		for (size_t k = 0; k < header.planes; k++)
+			for (size_t r = 0; r < header.height; r++)
+				if (rows[k * words + r * wordsPerRow + wordsPerRow - 1] & tail)
+					throw "Error: Cells Outside the .brd2 Board";
+
+	set<int> birthRule, survivalRule;
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	string rule(file.begin() + sizeof(header), header.ruleLength);
+	if (!string2rule(rule, birthRule, survivalRule, range, neighbourhood, states, transitions))
+		throw "Error Parsing Rules";
+	Topology topology = (Topology)header.topology;
+	if (header.topology > SPHERE)
+		throw "Error Parsing Rules";
+
+	BoardData ret = {topology != PLANE, (int)header.height, (int)header.width, header.iterations, header.births, header.deaths,
+		birthRule, survivalRule, range, neighbourhood, states, transitions,
+		vector<vector<bool>>()};
+	ret.topology = topology;
+	ret.packed.assign(rows, rows + words);
+	if (header.planes > 1)
+	{
+		ret.cellStates.assign(header.height, vector<unsigned char>(header.width, 0));
+		for (size_t k = 1; k < header.planes; k++)
+			for (size_t r = 0; r < header.height; r++)
+				for (size_t w = 0; w < wordsPerRow; w++)
+					for (uint64_t bits = rows[k * words + r * wordsPerRow + w]; bits; bits &= bits - 1)
+					{
+						size_t c = w * 64 + __builtin_ctzll(bits);
+						ret.cellStates[r][c] |= 1 << (k - 1);
+					}
+		//the planes hold the state minus one
+		for (auto& row : ret.cellStates)
+			for (auto& state : row)
+				state = (state > 0) ? state + 1 : 0;
+	}
+	return ret;
+}
+
+/* loads a macrocell (.mc) file (see Macrocell)
+A saved board has its size in the topology suffix of its rule, and is put back where Golly
+puts a bounded grid. Any other pattern gets a board just big enough for its live cells.
+Every cell is unpacked, so the patterns that only fit as a quadtree are for HashLife.*/
+BoardData loadMC(string filename)
+{
+	Macrocell tree(filename);
+	set<int> birthRule = {3,};
+	set<int> survivalRule = {2, 3,};
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	Topology topology = TORUS;
+	if (!tree.rule.empty() && (!string2rule(tree.rule, birthRule, survivalRule, range, neighbourhood, states, transitions) ||
+		!string2topology(tree.rule, topology)))
+		throw "Error Parsing Rules";
+	long long births = 0, deaths = 0;
+	for (auto& comment : tree.comments)
+		sscanf(comment.c_str(), "births %lld, deaths %lld", &births, &deaths);
+
+	int height = 0, width = 0;
+	long long top = 0, left = 0, bottom = 0, right = 0;
+	if (string2size(tree.rule, height, width) && height > 0 && width > 0)
+	{
+		top = -(height / 2);
+		left = -(width / 2);
+	}
+	else if (tree.bounds(top, left, bottom, right))
+	{
+		if (bottom - top > INT_MAX || right - left > INT_MAX || (bottom - top) * ((right - left + 63) / 64) > (1LL << 30))
+			throw "Error: Pattern Too Big For A Board";
+		height = bottom - top;
+		width = right - left;
+	}
+
+	BoardData ret = {true, height, width, tree.generation, births, deaths,
+		birthRule, survivalRule, range, neighbourhood, states, transitions,
+		vector<vector<bool>>()};
+	ret.topology = topology;
+	ret.packed = tree.unpack(top, left, height, width);
+	return ret;
+}
+
+//the column and row of every live cell, whether the loader packed them or not
+vector<pair<int, int>> liveCells(const BoardData& data)
+{
+	vector<pair<int, int>> living;
+	if (!data.packed.empty())
+	{
+		const size_t wordsPerRow = (data.width + 63) / 64;
+		for (int r = 0; r < data.height; r++)
+			for (size_t w = 0; w < wordsPerRow; w++)
+				for (uint64_t bits = data.packed[r * wordsPerRow + w]; bits; bits &= bits - 1)
+					living.push_back(make_pair((int)(w * 64 + __builtin_ctzll(bits)), r));
+		return living;
+	}
+	for (size_t r = 0; r < data.matrix.size(); r++)
+		for (size_t c = 0; c < data.matrix[r].size(); c++)
+			if (data.matrix[r][c])
+				living.push_back(make_pair((int)c, (int)r));
+	return living;
+}
+
+//loads a board from any format, .brd2 files are recognised by their first bytes and the others by their extension
 BoardData loadFormat(string filename)
 {
+	char magic[sizeof(BRD2_MAGIC)] = {0};
+	ifstream(filename, ios::binary).read(magic, sizeof(magic));
+	if (memcmp(magic, BRD2_MAGIC, sizeof(magic)) == 0)
+		return loadBRD2(filename);
+
 	if      (endsWith(filename, ".life") ||
 			 endsWith(filename, ".lif"))
 		return loadLife(filename);
@@ -251,6 +762,12 @@ BoardData loadFormat(string filename)
 	else if (endsWith(filename, ".brd"))
 		return loadBRD(filename);
 
+	else if (endsWith(filename, ".cells"))
+		return loadCells(filename);
+
+	else if (endsWith(filename, ".mc"))
+		return loadMC(filename);
+
 	else
 		throw "Unknown File Type";
 }
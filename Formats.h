@@ -2,8 +2,11 @@
 #ifndef FORMATS_H_
 #define FORMATS_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "Util.h"
 
@@ -14,8 +17,62 @@ typedef struct{
 	int y;
 } coords;
 
+/* a file mapped into memory read only, so a loader can scan it in place (and from several
+ * threads) instead of reading it line by line into strings. The mapping lasts as long as
+ * the object.
+ */
+class MappedFile
+{
+	const char * data;		//the first byte of the file, nullptr for an empty file
+	size_t size;			//number of bytes in the file
+	void * file;			//the file handle on Windows, unused elsewhere
+	void * mapping;			//the mapping handle on Windows, unused elsewhere
+
+public:
+	MappedFile(string filename);	//maps the whole file, throws if it cannot be opened
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	const char * begin();			//returns the first byte of the file
+	const char * end();				//returns one past the last byte of the file
+};
+
+/* the header of a .brd2 file, the binary board format. The header is followed by the rule
+ * (ruleLength bytes, padded with zeros to a multiple of 8) and then by the cells exactly as
+ * Board packs them: (width + 63) / 64 little endian words a row, one row after another, so
+ * they are copied into the board as they are. Generations boards have their dying states
+ * after the cells, one more such block of rows for each bit of the state (see Board::ages).
+ * Both checksums are brd2Checksum() values.
+ */
+struct BRD2Header
+{
+	char magic[8];				//BRD2_MAGIC, how loadFormat() recognises the format
+	uint32_t version;			//BRD2_VERSION
+	uint32_t headerSize;		//bytes before the first row: this header and the padded rule
+	uint32_t height;			//height of the board
+	uint32_t width;				//width of the board
+	uint32_t topology;			//the surface the board is (Topology), PLANE is the only one that does not wrap around
+	uint32_t planes;			//blocks of rows: 1 for the live cells, plus one for each bit of the dying states
+	int64_t iterations;			//number of iterations that were run
+	int64_t births;				//number of births so far
+	int64_t deaths;				//number of deaths so far
+	uint32_t ruleLength;		//length of the rule string, eg "B3/S23"
+	uint32_t reserved;			//0
+	uint64_t dataChecksum;		//checksum of each block of rows in turn, seeded with the checksum of the ones before
+	uint64_t headerChecksum;	//checksum of the header (with this field 0) and the padded rule
+};
+
+static const char BRD2_MAGIC[8] = {'G', 'o', 'G', 'b', 'r', 'd', '2', '\n'};	//the first 8 bytes of a .brd2 file
+static const uint32_t BRD2_VERSION = 1;				//the version of the format written
+
+uint64_t brd2Checksum(const void * data, size_t bytes, uint64_t seed = 0);	//the checksum of a multiple of 8 bytes, as .brd2 files use
+
 BoardData loadLife(string filename);
 BoardData loadRLE(string filename);
 BoardData loadFormat(string filename);
 BoardData loadBRD(string filename);
+BoardData loadCells(string filename);
+BoardData loadBRD2(string filename);
+BoardData loadMC(string filename);
+vector<pair<int, int>> liveCells(const BoardData& data);	//the column and row of every live cell, whether the loader packed them or not
 #endif /* FORMATS_H_ */
@@ -1,4 +1,5 @@
 #include "Controller.h"
+#include "Console.h"
 #include <ctime>
 #include <exception>
 #define SCREEN_HEIGHT 600
@@ -11,6 +12,7 @@ void MainMenu(Controller *controller)
 	options.push_back("Load Saved Board");
 	options.push_back("Load Random Board");
 	options.push_back("Enter Pattern Editor");
+	options.push_back("Engine: " + engineName(controller->getEngine()));
 	options.push_back("Exit");
 
 	switch( controller->getButtonInput("Welcome to Game of Life (in SDL)", options))
@@ -23,7 +25,8 @@ void MainMenu(Controller *controller)
 			controller->clearScreen();
 			int width = controller->getIntInput("Enter board width: ");
 			controller->clearScreen();
-			bool wrapAround = controller->getYesOrNo("Would you like to enable wrap around?");
+			//HashLife and the sparse plane are unbounded, only a Board can wrap around
+			bool wrapAround = controller->getEngine() == BOARD_ENGINE && controller->getYesOrNo("Would you like to enable wrap around?");
 			controller->createNewBoard(wrapAround, height, width);
 			controller->setState(PAUSED);
 			break;
@@ -36,7 +39,7 @@ void MainMenu(Controller *controller)
 			//Loop until we get a valid filename
 			while(!isFileValid)
 			{
-				filename = controller->getStringInput("Enter board filename:");
+				filename = controller->browseLibrary();
 				if(filename == "")
 					break;
 				try
@@ -50,7 +53,7 @@ void MainMenu(Controller *controller)
 				}
 				isFileValid = true;
 			}
-			//If user entered nothing, cancel loading a saved board
+			//If the user picked nothing, cancel loading a saved board
 			if(filename == "")
 				break;
 			controller->setState(PAUSED);
@@ -65,7 +68,8 @@ void MainMenu(Controller *controller)
 			controller->clearScreen();
 			int width = controller->getIntInput("Enter board width: ");
 			controller->clearScreen();
-			bool wrapAround = controller->getYesOrNo("Would you like to enable wrap around?");
+			//HashLife and the sparse plane are unbounded, only a Board can wrap around
+			bool wrapAround = controller->getEngine() == BOARD_ENGINE && controller->getYesOrNo("Would you like to enable wrap around?");
 			controller->clearScreen();
 			double ratio = controller->getRatioInput("Enter the proportion of cells to randomly turn on:");
 			controller->createNewBoard(wrapAround, height, width);
@@ -87,9 +91,23 @@ void MainMenu(Controller *controller)
 			controller->setState(EDITING);
 			break;
 		}
+		//Choose the engine the next boards are made with
+		case 4:
+		{
+			std::vector<engineType> engines = {BOARD_ENGINE, HASHLIFE_ENGINE, SPARSE_ENGINE};
+			std::vector<std::string> names;
+			for (engineType type : engines)
+				names.push_back(engineName(type));
+			controller->clearScreen();
+			int picked = controller->getButtonInput("Run new boards with which engine?", names);
+			if (picked >= 0)
+				controller->setEngine(engines[picked]);
+			controller->clearScreen();
+			break;
+		}
 		//Exit
 		case -1:
-		case 4:
+		case 5:
 			controller->setState(EXITING);
 			break;
 	}
@@ -143,6 +161,10 @@ bool init()
 
 int main(int argc, char** args)
 {
+	//commands like --bench run in the console, without a window
+	if (argc > 1)
+		return runConsole(argc, args);
+
     //Setup
 	srand(time(0));
 	std::cout << "About to begin\n";
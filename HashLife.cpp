@@ -0,0 +1,714 @@
+#include "HashLife.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+
+using namespace std;
+
+/* How the engine works: a node of level L is a 2^L wide square. Its result is the
+ * centre half of the square (a node of level L - 1) advanced 2^min(stepLog, L - 2)
+ * generations, which only depends on the cells inside the node. Because nodes are
+ * canonical, that result is computed once per distinct block and then looked up, so a
+ * pattern made of many copies of the same parts costs as much as one copy of each part.
+ */
+
+const uint32_t HashLife::NONE;
+
+static const size_t DEFAULT_MEMORY_MB = 512;	//default size of the node store
+
+//an empty universe, looked at through a height by width window
+HashLife::HashLife(int height, int width)
+{
+	freeList = NONE;
+	liveNodes = 0;
+	setMemoryLimit(DEFAULT_MEMORY_MB);
+	stepLog = 0;
+	setRule(CONWAY);
+	this->height = height;
+	this->width = width;
+	this->top = 0;
+	this->left = 0;
+	this->iterations = 0;
+	setCells(vector<pair<int, int>>());
+}
+
+//loads a universe from any format loadFormat() reads, macrocell files without unpacking them
+HashLife::HashLife(string filename)
+{
+	freeList = NONE;
+	liveNodes = 0;
+	setMemoryLimit(DEFAULT_MEMORY_MB);
+	stepLog = 0;
+	top = 0;
+	left = 0;
+	if (endsWith(filename, ".mc"))
+	{
+		loadMacrocell(filename);
+		return;
+	}
+	BoardData data = loadFormat(filename);
+	setRule(makeRule(data.birthRule, data.survivalRule, data.range, data.neighbourhood, data.states, data.transitions));
+	height = data.height;
+	width = data.width;
+	iterations = data.iterations;
+	setCells(liveCells(data));
+}
+
+//rebuilds the universe from the column and row of every live cell
+void HashLife::setCells(vector<pair<int, int>> living)
+{
+	nodes.clear();
+	pinned.clear();
+	emptyNodes.assign(1, NONE);
+	freeList = NONE;
+	liveNodes = 0;
+	rehash(1 << 16);
+
+	//the window starts at the origin, so the root only has to reach max(height, width) to the right and down
+	int level = 4;
+	while ((1LL << (level - 1)) < max(height, width))
+		level++;
+	long long half = 1LL << (level - 1);
+	root = NONE;
+	root = build(level, -half, -half, living.begin(), living.end());
+}
+
+/* rebuilds the universe from a macrocell file
+The file's nodes come children first, so each one is made from nodes already made, and its
+root becomes the root of the universe: both are centred on the origin. The area looked at
+is the bounded grid of a saved board, or else the live cells.*/
+void HashLife::loadMacrocell(string filename)
+{
+	Macrocell tree(filename);
+	set<int> birthRule = {3,};
+	set<int> survivalRule = {2, 3,};
+	int range = 0;
+	char neighbourhood = 'M';
+	int states = 2;
+	vector<bool> transitions;
+	if (!tree.rule.empty() && !string2rule(tree.rule, birthRule, survivalRule, range, neighbourhood, states, transitions))
+		throw "Error Parsing Rules";
+	setRule(makeRule(birthRule, survivalRule, range, neighbourhood, states, transitions));
+	iterations = tree.generation;
+	height = 0;
+	width = 0;
+	setCells(vector<pair<int, int>>());
+
+	long long bottom, right;
+	if (string2size(tree.rule, height, width) && height > 0 && width > 0)
+	{
+		top = -(height / 2);
+		left = -(width / 2);
+	}
+	else if (tree.bounds(top, left, bottom, right))
+	{
+		height = min(bottom - top, (long long)INT_MAX);
+		width = min(right - left, (long long)INT_MAX);
+	}
+
+	//every node made is pinned until the root holds them all
+	size_t mark = pinned.size();
+	vector<uint32_t> converted(tree.getNodeCount(), NONE);
+	for (uint32_t i = 1; i < tree.getNodeCount(); i++)
+	{
+		int level = tree.getLevel(i);
+		if (level == Macrocell::LEAF_LEVEL)
+		{
+			converted[i] = pin(block(tree.getCells(i), level, 0, 0));
+			continue;
+		}
+		uint32_t children[4];
+		for (int q = 0; q < 4; q++)
+		{
+			uint32_t child = tree.getChild(i, q);
+			children[q] = (child == 0) ? emptyNode(level - 1) : converted[child];
+		}
+		converted[i] = pin(join(children[0], children[1], children[2], children[3]));
+	}
+	root = (tree.getRoot() == 0) ? emptyNode(max(4, tree.getRootLevel())) : converted[tree.getRoot()];
+	while (nodes[root].level < 4)
+		expand();
+	pinned.resize(mark);
+}
+
+//returns the node of the 2^level wide block of a macrocell leaf (bit 8 * row + column) with its top left corner at (x, y)
+uint32_t HashLife::block(uint64_t cells, int level, int y, int x)
+{
+	if (level == 1)
+		return leaf(((cells >> (y * 8 + x)) & 3) | (((cells >> ((y + 1) * 8 + x)) & 3) << 2));
+	int half = 1 << (level - 1);
+	size_t mark = pinned.size();
+	uint32_t nw = pin(block(cells, level - 1, y, x));
+	uint32_t ne = pin(block(cells, level - 1, y, x + half));
+	uint32_t sw = pin(block(cells, level - 1, y + half, x));
+	uint32_t se = pin(block(cells, level - 1, y + half, x + half));
+	uint32_t node = join(nw, ne, sw, se);
+	pinned.resize(mark);
+	return node;
+}
+
+//returns the cells of a node of level 3 or below as a macrocell leaf (bit 8 * row + column)
+uint64_t HashLife::blockCells(uint32_t node)
+{
+	const Node& n = nodes[node];
+	if (n.level == 1)
+		return (n.child[0] & 3) | ((uint64_t)(n.child[0] >> 2) << 8);
+	int half = 1 << (n.level - 1);
+	uint64_t cells = 0;
+	for (int q = 0; q < 4; q++)
+		cells |= blockCells(n.child[q]) << ((q >> 1) * half * 8 + (q & 1) * half);
+	return cells;
+}
+
+//adds a node to a macrocell tree, each node once however many times it is used
+uint32_t HashLife::toMacrocell(uint32_t node, Macrocell& tree, vector<uint32_t>& converted)
+{
+	if (nodes[node].population == 0)
+		return 0;
+	if (converted[node] != NONE)
+		return converted[node];
+	const Node& n = nodes[node];
+	if (n.level == Macrocell::LEAF_LEVEL)
+		converted[node] = tree.leaf(blockCells(node));
+	else
+		converted[node] = tree.join(toMacrocell(n.child[0], tree, converted), toMacrocell(n.child[1], tree, converted),
+			toMacrocell(n.child[2], tree, converted), toMacrocell(n.child[3], tree, converted), n.level);
+	return converted[node];
+}
+
+/* saves the whole universe as a macrocell file
+The quadtree is written as it is, a line per distinct node, so this costs as much as the
+nodes the root uses, however many cells they cover. The universe has no edges, so the rule
+has no topology suffix.*/
+void HashLife::saveMacrocell(string fileName)
+{
+	Macrocell tree;
+	vector<uint32_t> converted(nodes.size(), NONE);
+	tree.setRoot(toMacrocell(root, tree, converted), nodes[root].level);
+	tree.rule = ruleString(rule);
+	tree.generation = iterations;
+	tree.save(fileName);
+}
+
+//keeps a node alive until the pinned stack is unwound
+uint32_t HashLife::pin(uint32_t node)
+{
+	pinned.push_back(node);
+	return node;
+}
+
+//hashes the quadrants of a node
+uint64_t HashLife::hash(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+{
+	uint64_t h = nw;
+	h = h * 0x9E3779B97F4A7C15ULL + ne;
+	h = h * 0x9E3779B97F4A7C15ULL + sw;
+	h = h * 0x9E3779B97F4A7C15ULL + se;
+	return h ^ (h >> 29);
+}
+
+//rebuilds the hash table with the given number of buckets
+void HashLife::rehash(size_t size)
+{
+	buckets.assign(size, NONE);
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		if (nodes[i].level == 0)
+			continue;
+		const uint32_t * c = nodes[i].child;
+		uint64_t bucket = hash(c[0], c[1], c[2], c[3]) & (buckets.size() - 1);
+		nodes[i].next = buckets[bucket];
+		buckets[bucket] = i;
+	}
+}
+
+//takes a free node slot, collecting garbage if needed
+uint32_t HashLife::allocate()
+{
+	if (freeList == NONE && nodes.size() >= collectAt)
+	{
+		collectGarbage(true);
+		//if the memoized results alone fill the store, drop them too
+		if (liveNodes * sizeof(Node) > memoryLimit / 2)
+			collectGarbage(false);
+		//when the pattern itself needs more than the limit, let the store grow instead of collecting over and over
+		collectAt = max(memoryLimit / sizeof(Node), liveNodes + liveNodes / 2);
+	}
+	uint32_t node;
+	if (freeList != NONE)
+	{
+		node = freeList;
+		freeList = nodes[node].next;
+	}
+	else
+	{
+		node = nodes.size();
+		nodes.push_back(Node());
+	}
+	liveNodes++;
+	if (liveNodes > buckets.size())
+		rehash(buckets.size() * 2);
+	return node;
+}
+
+//returns the canonical level 1 node with the given cells
+uint32_t HashLife::leaf(int bits)
+{
+	uint64_t bucket = hash(bits, 0, 0, 0) & (buckets.size() - 1);
+	for (uint32_t i = buckets[bucket]; i != NONE; i = nodes[i].next)
+	{
+		if (nodes[i].level == 1 && nodes[i].child[0] == (uint32_t)bits)
+			return i;
+	}
+	uint32_t node = allocate();
+	Node& n = nodes[node];
+	n.child[0] = bits;
+	n.child[1] = n.child[2] = n.child[3] = 0;
+	n.result = NONE;
+	n.population = __builtin_popcount(bits);
+	n.level = 1;
+	n.marked = false;
+	bucket = hash(bits, 0, 0, 0) & (buckets.size() - 1);
+	n.next = buckets[bucket];
+	buckets[bucket] = node;
+	return node;
+}
+
+//returns the canonical node with the given quadrants
+uint32_t HashLife::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+{
+	int level = nodes[nw].level + 1;
+	uint64_t bucket = hash(nw, ne, sw, se) & (buckets.size() - 1);
+	for (uint32_t i = buckets[bucket]; i != NONE; i = nodes[i].next)
+	{
+		const Node& n = nodes[i];
+		if (n.level == level && n.child[0] == nw && n.child[1] == ne && n.child[2] == sw && n.child[3] == se)
+			return i;
+	}
+	//the quadrants are not referenced by anything yet, so they must survive a collection in allocate()
+	size_t mark = pinned.size();
+	pin(nw);
+	pin(ne);
+	pin(sw);
+	pin(se);
+	uint32_t node = allocate();
+	pinned.resize(mark);
+	Node& n = nodes[node];
+	n.child[0] = nw;
+	n.child[1] = ne;
+	n.child[2] = sw;
+	n.child[3] = se;
+	n.result = NONE;
+	n.population = nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population;
+	n.level = level;
+	n.marked = false;
+	bucket = hash(nw, ne, sw, se) & (buckets.size() - 1);
+	n.next = buckets[bucket];
+	buckets[bucket] = node;
+	return node;
+}
+
+//returns the empty node of a level
+uint32_t HashLife::emptyNode(int level)
+{
+	if (emptyNodes.size() < 2)
+		emptyNodes.push_back(leaf(0));
+	while ((int)emptyNodes.size() <= level)
+	{
+		uint32_t e = emptyNodes.back();
+		uint32_t node = join(e, e, e, e);
+		emptyNodes.push_back(node);
+	}
+	return emptyNodes[level];
+}
+
+//returns the centre half of a node, one level down
+uint32_t HashLife::centre(uint32_t node)
+{
+	const uint32_t * c = nodes[node].child;
+	uint32_t nw = c[0], ne = c[1], sw = c[2], se = c[3];
+	if (nodes[node].level == 2)
+	{
+		//take the inner corner cell of each level 1 quadrant
+		int bits = ((nodes[nw].child[0] >> 3) & 1) | (((nodes[ne].child[0] >> 2) & 1) << 1)
+			| (((nodes[sw].child[0] >> 1) & 1) << 2) | ((nodes[se].child[0] & 1) << 3);
+		return leaf(bits);
+	}
+	return join(nodes[nw].child[3], nodes[ne].child[2], nodes[sw].child[1], nodes[se].child[0]);
+}
+
+//result() for level 2 nodes: one generation of the centre 2x2 cells, read from the table
+uint32_t HashLife::leafResult(uint32_t node)
+{
+	int block = 0;
+	for (int q = 0; q < 4; q++)
+	{
+		int bits = nodes[nodes[node].child[q]].child[0];
+		int x = (q & 1) * 2;
+		int y = (q >> 1) * 2;
+		block |= (bits & 1) << (y * 4 + x);
+		block |= ((bits >> 1) & 1) << (y * 4 + x + 1);
+		block |= ((bits >> 2) & 1) << ((y + 1) * 4 + x);
+		block |= ((bits >> 3) & 1) << ((y + 1) * 4 + x + 1);
+	}
+	return leaf(table[block]);
+}
+
+//returns the centre half of a node, advanced 2^min(stepLog, level - 2) generations
+uint32_t HashLife::result(uint32_t node)
+{
+	if (nodes[node].result != NONE)
+		return nodes[node].result;
+
+	int level = nodes[node].level;
+	uint32_t r;
+	if (nodes[node].population == 0)
+		r = emptyNode(level - 1);
+	else if (level == 2)
+		r = leafResult(node);
+	else
+	{
+		size_t mark = pinned.size();
+		uint32_t nw = nodes[node].child[0], ne = nodes[node].child[1];
+		uint32_t sw = nodes[node].child[2], se = nodes[node].child[3];
+		const uint32_t * w = nodes[nw].child;
+		const uint32_t * e = nodes[ne].child;
+		const uint32_t * s = nodes[sw].child;
+		const uint32_t * t = nodes[se].child;
+		uint32_t nwNe = w[1], nwSw = w[2], nwSe = w[3];
+		uint32_t neNw = e[0], neSw = e[2], neSe = e[3];
+		uint32_t swNw = s[0], swNe = s[1], swSe = s[3];
+		uint32_t seNw = t[0], seNe = t[1], seSw = t[2];
+
+		//the nine overlapping half size nodes, three rows of three
+		uint32_t n01 = pin(join(nwNe, neNw, nwSe, neSw));
+		uint32_t n10 = pin(join(nwSw, nwSe, swNw, swNe));
+		uint32_t n11 = pin(join(nwSe, neSw, swNe, seNw));
+		uint32_t n12 = pin(join(neSw, neSe, seNw, seNe));
+		uint32_t n21 = pin(join(swNe, seNw, swSe, seSw));
+
+		//advance each of them (2^(level - 3) generations at full speed, less for smaller steps)
+		uint32_t r00 = pin(result(nw));
+		uint32_t r01 = pin(result(n01));
+		uint32_t r02 = pin(result(ne));
+		uint32_t r10 = pin(result(n10));
+		uint32_t r11 = pin(result(n11));
+		uint32_t r12 = pin(result(n12));
+		uint32_t r20 = pin(result(sw));
+		uint32_t r21 = pin(result(n21));
+		uint32_t r22 = pin(result(se));
+
+		//regroup them into the four quadrants of the answer
+		uint32_t a = pin(join(r00, r01, r10, r11));
+		uint32_t b = pin(join(r01, r02, r11, r12));
+		uint32_t c = pin(join(r10, r11, r20, r21));
+		uint32_t d = pin(join(r11, r12, r21, r22));
+
+		if (stepLog >= level - 2)
+		{
+			//full speed: advance the quadrants a second time
+			uint32_t ra = pin(result(a));
+			uint32_t rb = pin(result(b));
+			uint32_t rc = pin(result(c));
+			uint32_t rd = pin(result(d));
+			r = join(ra, rb, rc, rd);
+		}
+		else
+		{
+			//the step is already used up, just cut out the centres
+			uint32_t ca = pin(centre(a));
+			uint32_t cb = pin(centre(b));
+			uint32_t cc = pin(centre(c));
+			uint32_t cd = pin(centre(d));
+			r = join(ca, cb, cc, cd);
+		}
+		pinned.resize(mark);
+	}
+	nodes[node].result = r;
+	return r;
+}
+
+//builds the node covering the given live cells, with its top left corner at (x0, y0)
+uint32_t HashLife::build(int level, long long x0, long long y0,
+	vector<pair<int, int>>::iterator first, vector<pair<int, int>>::iterator last)
+{
+	if (first == last)
+		return emptyNode(level);
+	if (level == 1)
+	{
+		int bits = 0;
+		for (auto it = first; it != last; ++it)
+			bits |= 1 << ((it->second - y0) * 2 + (it->first - x0));
+		return leaf(bits);
+	}
+	long long half = 1LL << (level - 1);
+	auto south = partition(first, last, [&](const pair<int, int>& p) { return p.second < y0 + half; });
+	auto northEast = partition(first, south, [&](const pair<int, int>& p) { return p.first < x0 + half; });
+	auto southEast = partition(south, last, [&](const pair<int, int>& p) { return p.first < x0 + half; });
+
+	size_t mark = pinned.size();
+	uint32_t nw = pin(build(level - 1, x0, y0, first, northEast));
+	uint32_t ne = pin(build(level - 1, x0 + half, y0, northEast, south));
+	uint32_t sw = pin(build(level - 1, x0, y0 + half, south, southEast));
+	uint32_t se = pin(build(level - 1, x0 + half, y0 + half, southEast, last));
+	uint32_t node = join(nw, ne, sw, se);
+	pinned.resize(mark);
+	return node;
+}
+
+//returns node (with its top left corner at (x0, y0)) with the cell at (x, y) set to living
+uint32_t HashLife::setCell(uint32_t node, long long x0, long long y0, long long x, long long y, bool living)
+{
+	int level = nodes[node].level;
+	if (level == 1)
+	{
+		int bit = 1 << ((y - y0) * 2 + (x - x0));
+		int bits = nodes[node].child[0];
+		return leaf(living ? (bits | bit) : (bits & ~bit));
+	}
+	long long half = 1LL << (level - 1);
+	int q = (x >= x0 + half) + 2 * (y >= y0 + half);
+	uint32_t children[4];
+	for (int i = 0; i < 4; i++)
+		children[i] = nodes[node].child[i];
+	children[q] = setCell(children[q], x0 + (q & 1) * half, y0 + (q >> 1) * half, x, y, living);
+	return join(children[0], children[1], children[2], children[3]);
+}
+
+//doubles the universe, keeping it centred on the origin
+void HashLife::expand()
+{
+	size_t mark = pinned.size();
+	uint32_t nw = nodes[root].child[0], ne = nodes[root].child[1];
+	uint32_t sw = nodes[root].child[2], se = nodes[root].child[3];
+	uint32_t e = pin(emptyNode(nodes[root].level - 1));
+	uint32_t bigNw = pin(join(e, e, e, nw));
+	uint32_t bigNe = pin(join(e, e, ne, e));
+	uint32_t bigSw = pin(join(e, sw, e, e));
+	uint32_t bigSe = pin(join(se, e, e, e));
+	root = join(bigNw, bigNe, bigSw, bigSe);
+	pinned.resize(mark);
+}
+
+//true if the universe covers the cell
+bool HashLife::contains(long long x, long long y)
+{
+	long long half = 1LL << (nodes[root].level - 1);
+	return x >= -half && x < half && y >= -half && y < half;
+}
+
+//true if the root can be advanced 2^log generations without losing cells
+bool HashLife::settled(int log)
+{
+	if (nodes[root].level < max(4, log + 3))
+		return false;
+	//every live cell has to be in the middle quarter, so it can grow 2^(level - 3) cells each way
+	//and still land inside the result
+	const uint32_t * c = nodes[root].child;
+	uint64_t middle = nodes[nodes[nodes[c[0]].child[3]].child[3]].population
+		+ nodes[nodes[nodes[c[1]].child[2]].child[2]].population
+		+ nodes[nodes[nodes[c[2]].child[1]].child[1]].population
+		+ nodes[nodes[nodes[c[3]].child[0]].child[0]].population;
+	return middle == nodes[root].population;
+}
+
+//changes the step size, forgetting the memoized results
+void HashLife::setStep(int log)
+{
+	if (log == stepLog)
+		return;
+	forgetResults();
+	stepLog = log;
+}
+
+//clears every memoized result
+void HashLife::forgetResults()
+{
+	for (auto& node : nodes)
+		node.result = NONE;
+}
+
+//advances the universe 2^log generations
+void HashLife::stepPower(int log)
+{
+	setStep(log);
+	while (!settled(log))
+		expand();
+	root = result(root);
+	iterations += 1LL << log;
+}
+
+//frees every node the root and the pinned stack do not use
+void HashLife::collectGarbage(bool keepResults)
+{
+	vector<uint32_t> stack(pinned);
+	stack.push_back(root);
+	stack.insert(stack.end(), emptyNodes.begin(), emptyNodes.end());
+	while (!stack.empty())
+	{
+		uint32_t node = stack.back();
+		stack.pop_back();
+		if (node == NONE || nodes[node].marked)
+			continue;
+		nodes[node].marked = true;
+		if (nodes[node].level > 1)
+			stack.insert(stack.end(), nodes[node].child, nodes[node].child + 4);
+		if (keepResults)
+			stack.push_back(nodes[node].result);
+	}
+
+	freeList = NONE;
+	liveNodes = 0;
+	for (size_t i = nodes.size(); i-- > 0;)
+	{
+		if (nodes[i].marked)
+		{
+			nodes[i].marked = false;
+			if (!keepResults)
+				nodes[i].result = NONE;
+			liveNodes++;
+		}
+		else
+		{
+			nodes[i].level = 0;
+			nodes[i].next = freeList;
+			freeList = i;
+		}
+	}
+	rehash(buckets.size());
+}
+
+//toggles the cell from true to false or false to true
+void HashLife::toggle(int r, int c)
+{
+	toggle(r, c, !getCell(r, c));
+}
+
+//sets the cell to living
+void HashLife::toggle(int r, int c, bool living)
+{
+	while (!contains(left + c, top + r))
+		expand();
+	long long half = 1LL << (nodes[root].level - 1);
+	root = setCell(root, -half, -half, left + c, top + r, living);
+}
+
+//runs one iteration
+void HashLife::runIteration()
+{
+	runIteration(1);
+}
+
+//runs the given number of iterations, one power of two jump for every bit set in runs
+void HashLife::runIteration(long long runs)
+{
+	for (int log = 0; log < 62 && (runs >> log) > 0; log++)
+	{
+		if ((runs >> log) & 1)
+			stepPower(log);
+	}
+}
+
+//save the viewed area as a .brd file, or the whole universe as a .mc file
+void HashLife::saveState(string fileName)
+{
+	if (endsWith(fileName, ".mc"))
+	{
+		saveMacrocell(fileName);
+		return;
+	}
+	ofstream out(fileName);
+	out << height << endl;
+	out << width << endl;
+	out << false << endl;	//the universe is an unbounded plane
+	out << iterations << endl;
+	out << 0 << endl;		//births and deaths are not tracked
+	out << 0 << endl;
+	out << ruleString(rule) << endl;
+	string line(width, '0');
+	for (int i = 0; i < height; i++)
+	{
+		for (int j = 0; j < width; j++)
+			line[j] = getCell(i, j) ? '1' : '0';
+		out << line << endl;
+	}
+}
+
+//sets how big the node store may grow before it is garbage collected
+void HashLife::setMemoryLimit(size_t megabytes)
+{
+	memoryLimit = megabytes << 20;
+	collectAt = memoryLimit / sizeof(Node);
+}
+
+//changes the birth and survival rule (B0, Larger than Life and Generations rules are not supported)
+void HashLife::setRule(const Rule& rule)
+{
+	if (rule.range > 0)
+		throw "HashLife cannot run Larger than Life rules";
+	if (rule.dyingStates > 0)
+		throw "HashLife cannot run Generations rules";
+	if (rule.birth & 1)
+		throw "HashLife cannot run rules with births on 0 neighbours";
+	this->rule = rule;
+	table = lifeTable(rule);
+	forgetResults();
+}
+
+//returns the birth and survival rule
+Rule HashLife::getRule()
+{
+	return rule;
+}
+
+//returns true if the cell is alive
+bool HashLife::getCell(int r, int c)
+{
+	if (!contains(left + c, top + r))
+		return false;
+	uint32_t node = root;
+	long long half = 1LL << (nodes[root].level - 1);
+	long long x = left + c + half, y = top + r + half;	//position inside the current node
+	while (nodes[node].level > 1)
+	{
+		if (nodes[node].population == 0)
+			return false;
+		half = 1LL << (nodes[node].level - 1);
+		int q = (x >= half) + 2 * (y >= half);
+		x -= (q & 1) * half;
+		y -= (q >> 1) * half;
+		node = nodes[node].child[q];
+	}
+	return (nodes[node].child[0] >> (y * 2 + x)) & 1;
+}
+
+//returns the height of the area the board looks at
+int HashLife::getHeight()
+{
+	return height;
+}
+
+//returns the width of the area the board looks at
+int HashLife::getWidth()
+{
+	return width;
+}
+
+//returns the number of iterations that were run
+long long HashLife::getIterations()
+{
+	return iterations;
+}
+
+//returns the number of live cells in the whole universe
+long long HashLife::getPopulation()
+{
+	return nodes[root].population;
+}
+
+//returns the number of nodes in use
+size_t HashLife::getNodeCount()
+{
+	return liveNodes;
+}
@@ -0,0 +1,110 @@
+//Header file for the HashLife engine
+#ifndef HASHLIFE_H_
+#define HASHLIFE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Engine.h"
+#include "Formats.h"
+#include "Macrocell.h"
+#include "Util.h"
+
+/* an engine for huge, highly regular patterns (metacells, Turing machines...).
+ * The universe is a quadtree whose nodes are hash-consed, so every distinct block of
+ * cells is stored once no matter how often it repeats. Each node remembers the result
+ * of running its centre forward, which lets the engine jump 2^k generations in one go.
+ * The universe is an unbounded plane: the height and width only describe the area
+ * getCell() and saveState() look at, and wrapAround is ignored. Macrocell files are read
+ * and written straight from and to the quadtree, so a pattern far too big to unpack
+ * (a metacell pattern, say) still loads and saves. Rules where cells are
+ * born with 0 neighbours would fill the infinite empty plane, so they are rejected,
+ * and so are Larger than Life and Generations rules.
+ */
+class HashLife : public Engine
+{
+	static const uint32_t NONE = 0xffffffff;	//marks a missing node index
+
+	/* a square block of 2^level by 2^level cells. Level 1 nodes hold their four cells
+	 * in the low bits of child[0] (bit 0 nw, 1 ne, 2 sw, 3 se), higher levels point at
+	 * their four quadrants. A level of 0 marks a free slot.
+	 */
+	struct Node
+	{
+		uint32_t child[4];		//the nw, ne, sw and se quadrants
+		uint32_t result;		//the centre advanced by the current step, NONE until it is computed
+		uint32_t next;			//next node in the same hash bucket (or the free list)
+		uint64_t population;	//number of live cells in the block
+		int level;				//the block is 2^level cells wide
+		bool marked;			//set while garbage collecting if the node is still in use
+	};
+
+	std::vector<Node> nodes;			//every node, referred to by index so they can be recycled
+	std::vector<uint32_t> buckets;		//hash table of canonical nodes, heads of chains through Node::next
+	std::vector<uint32_t> emptyNodes;	//the empty node of every level
+	std::vector<uint32_t> pinned;		//nodes being worked on, kept alive by the garbage collector
+	uint32_t freeList;					//first free node slot
+	size_t liveNodes;					//number of nodes in use
+	size_t memoryLimit;					//bytes the node store may use before it is garbage collected
+	size_t collectAt;					//number of node slots at which the next collection runs
+	uint32_t root;						//the whole universe, centred on the origin
+	int stepLog;						//the memoized results advance 2^stepLog generations
+	Rule rule;							//the birth and survival rule
+	const uint8_t * table;				//lifeTable() for the rule
+	int height;							//height of the area the board looks at
+	int width;							//width of the area the board looks at
+	long long top;						//row of the universe the area starts at
+	long long left;						//column of the universe the area starts at
+	long long iterations;				//number of iterations that have been run
+
+	uint32_t pin(uint32_t node);									//keeps a node alive until the pinned stack is unwound
+	uint32_t leaf(int bits);										//returns the canonical level 1 node with the given cells
+	uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);	//returns the canonical node with the given quadrants
+	uint32_t allocate();											//takes a free node slot, collecting garbage if needed
+	uint32_t emptyNode(int level);									//returns the empty node of a level
+	uint32_t centre(uint32_t node);									//returns the centre half of a node, one level down
+	uint32_t result(uint32_t node);									//returns the centre half of a node, advanced by the current step
+	uint32_t leafResult(uint32_t node);								//result() for level 2 nodes
+	uint32_t build(int level, long long x0, long long y0,
+		std::vector<std::pair<int, int>>::iterator first,
+		std::vector<std::pair<int, int>>::iterator last);			//builds the node covering the given live cells
+	uint32_t setCell(uint32_t node, long long x0, long long y0, long long x, long long y, bool living);	//returns node with one cell changed
+	void expand();													//doubles the universe, keeping it centred on the origin
+	bool contains(long long x, long long y);						//true if the universe covers the cell
+	bool settled(int log);											//true if the root can be advanced 2^log generations without losing cells
+	void setStep(int log);											//changes the step size, forgetting the memoized results
+	void forgetResults();											//clears every memoized result
+	void stepPower(int log);										//advances the universe 2^log generations
+	void collectGarbage(bool keepResults);							//frees every node the root and the pinned stack do not use
+	void rehash(size_t size);										//rebuilds the hash table with the given number of buckets
+	uint64_t hash(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);	//hashes the quadrants of a node
+
+	void setCells(std::vector<std::pair<int, int>> living);		//rebuilds the universe from the column and row of every live cell
+	uint32_t block(uint64_t cells, int level, int y, int x);	//returns the node of part of a macrocell leaf (bit 8 * row + column)
+	uint64_t blockCells(uint32_t node);							//returns the cells of a node of level 3 or below as a macrocell leaf
+	uint32_t toMacrocell(uint32_t node, Macrocell& tree, std::vector<uint32_t>& converted);	//adds a node to a macrocell tree
+	void loadMacrocell(std::string filename);					//rebuilds the universe from a macrocell file
+	void saveMacrocell(std::string fileName);					//saves the whole universe as a macrocell file
+
+public:
+	HashLife(int height, int width);					//an empty universe, looked at through a height by width window
+	HashLife(std::string filename);						//loads a universe from any format loadFormat() reads
+	void toggle(int r, int c);							//toggles the cell from true to false or false to true
+	void toggle(int r, int c, bool living);				//sets the cell to living
+	void runIteration();								//runs one iteration
+	void runIteration(long long runs);					//runs the given number of iterations, in power of two jumps
+	void saveState(std::string fileName);				//save the viewed area as a .brd file, or the whole universe as a .mc file
+	void setMemoryLimit(size_t megabytes);				//sets how big the node store may grow before it is garbage collected
+	void setRule(const Rule& rule);						//changes the birth and survival rule (B0, Larger than Life and Generations rules are not supported)
+	Rule getRule();										//returns the birth and survival rule
+
+	bool getCell(int r, int c);							//returns true if the cell is alive
+	int getHeight();									//returns the height of the area the board looks at
+	int getWidth();										//returns the width of the area the board looks at
+	long long getIterations();							//returns the number of iterations that were run
+	long long getPopulation();							//returns the number of live cells in the whole universe
+	size_t getNodeCount();								//returns the number of nodes in use
+};
+
+#endif /* HASHLIFE_H_ */
@@ -0,0 +1,370 @@
+//the kernels return vectors from always inlined helpers, which never cross a call, so GCC's warnings about vector returns changing the ABI do not apply
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+#include "Kernels.h"
+#include <array>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+/* The kernels below are all built from the same template. The vector types use the
+ * GCC vector extensions, so the template is plain C++ and each wrapper function is
+ * compiled for its own instruction set with the target attribute. That way a single
+ * binary carries every kernel, and the cpu is only asked which one to use at runtime.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86
+typedef uint64_t vec128 __attribute__((vector_size(16)));
+typedef uint64_t vec256 __attribute__((vector_size(32)));
+typedef uint64_t vec512 __attribute__((vector_size(64)));
+#endif
+
+//loads a vector from a (possibly unaligned) address
+template <typename V>
+static inline __attribute__((always_inline)) V load(const uint64_t* p)
+{
+	V v;
+	memcpy(&v, p, sizeof(V));
+	return v;
+}
+
+//computes the words [begin, end) LANES words at a time, then finishes off the remainder one word at a time
+template <typename V, int LANES, typename RULE>
+static inline __attribute__((always_inline)) void lifeSpan(const uint64_t* above, const uint64_t* row,
+	const uint64_t* below, uint64_t* out, int begin, int end, const RULE& rule, int& births, int& deaths)
+{
+	int i = begin;
+	for (; i + LANES <= end; i += LANES)
+	{
+		V a = load<V>(above + i), b = load<V>(row + i), c = load<V>(below + i);
+		V aW = (a << 1) | (load<V>(above + i - 1) >> 63);
+		V bW = (b << 1) | (load<V>(row + i - 1) >> 63);
+		V cW = (c << 1) | (load<V>(below + i - 1) >> 63);
+		V aE = (a >> 1) | (load<V>(above + i + 1) << 63);
+		V bE = (b >> 1) | (load<V>(row + i + 1) << 63);
+		V cE = (c >> 1) | (load<V>(below + i + 1) << 63);
+		V next = rule.template word<V>(aW, a, aE, bW, b, bE, cW, c, cE);
+		memcpy(out + i, &next, sizeof(V));
+		for (int j = i; j < i + LANES; j++)
+		{
+			births += __builtin_popcountll(out[j] & ~row[j]);
+			deaths += __builtin_popcountll(row[j] & ~out[j]);
+		}
+	}
+	for (; i < end; i++)
+	{
+		uint64_t next = rule.template word<uint64_t>(
+			(above[i] << 1) | (above[i - 1] >> 63), above[i], (above[i] >> 1) | (above[i + 1] << 63),
+			(row[i] << 1) | (row[i - 1] >> 63), row[i], (row[i] >> 1) | (row[i + 1] << 63),
+			(below[i] << 1) | (below[i - 1] >> 63), below[i], (below[i] >> 1) | (below[i + 1] << 63));
+		births += __builtin_popcountll(next & ~row[i]);
+		deaths += __builtin_popcountll(row[i] & ~next);
+		out[i] = next;
+	}
+}
+
+/* the HenselRule for a non-totalistic rule. Row kernels are handed a few words at a time
+ * (a tile row, the edge words), so each thread keeps the last one instead of building it
+ * on every call.
+ */
+static const HenselRule& henselRule(const Rule& rule)
+{
+	static thread_local Rule last = {};
+	static thread_local HenselRule hensel(last);
+	if (!sameCounts(rule, last))
+	{
+		hensel = HenselRule(rule);
+		last = rule;
+	}
+	return hensel;
+}
+
+/* picks the compiled version of lifeSpan() for the rule. The rules with their own
+ * version have every count check folded into constants; any other rule goes through
+ * MaskRule, which checks all nine counts against masks read at runtime, or HenselRule
+ * if it is non-totalistic. The von Neumann and hexagonal neighbourhoods have their own
+ * versions of MaskRule that only count their neighbours.
+ */
+template <typename V, int LANES>
+static inline __attribute__((always_inline)) void ruleSpan(const uint64_t* above, const uint64_t* row,
+	const uint64_t* below, uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths)
+{
+	if (rule.neighbourhood == 'N')
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, ShapedRule<VonNeumannNeighbourhood, MaskRule>(rule), births, deaths);
+	else if (rule.neighbourhood == 'H')
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, ShapedRule<HexagonalNeighbourhood, MaskRule>(rule), births, deaths);
+	else if (nonTotalistic(rule))
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, henselRule(rule), births, deaths);
+	else if (sameCounts(rule, CONWAY))
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, FixedRule<CONWAY.birth, CONWAY.survival>(), births, deaths);
+	else if (sameCounts(rule, HIGHLIFE))
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, FixedRule<HIGHLIFE.birth, HIGHLIFE.survival>(), births, deaths);
+	else if (sameCounts(rule, DAY_AND_NIGHT))
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, FixedRule<DAY_AND_NIGHT.birth, DAY_AND_NIGHT.survival>(), births, deaths);
+	else if (sameCounts(rule, SEEDS))
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, FixedRule<SEEDS.birth, SEEDS.survival>(), births, deaths);
+	else
+		lifeSpan<V, LANES>(above, row, below, out, begin, end, MaskRule(rule), births, deaths);
+}
+
+//computes the words [begin, end) of a batch row LANES words at a time, every neighbour is a whole word stride away
+template <typename V, int LANES, typename RULE>
+static inline __attribute__((always_inline)) void batchSpan(const uint64_t* above, const uint64_t* row,
+	const uint64_t* below, uint64_t* out, int begin, int end, int stride, const RULE& rule)
+{
+	int i = begin;
+	for (; i + LANES <= end; i += LANES)
+	{
+		V next = rule.template word<V>(load<V>(above + i - stride), load<V>(above + i), load<V>(above + i + stride),
+			load<V>(row + i - stride), load<V>(row + i), load<V>(row + i + stride),
+			load<V>(below + i - stride), load<V>(below + i), load<V>(below + i + stride));
+		memcpy(out + i, &next, sizeof(V));
+	}
+	for (; i < end; i++)
+	{
+		out[i] = rule.template word<uint64_t>(above[i - stride], above[i], above[i + stride],
+			row[i - stride], row[i], row[i + stride], below[i - stride], below[i], below[i + stride]);
+	}
+}
+
+//picks the compiled version of batchSpan() for the rule, as ruleSpan() does
+template <typename V, int LANES>
+static inline __attribute__((always_inline)) void batchRuleSpan(const uint64_t* above, const uint64_t* row,
+	const uint64_t* below, uint64_t* out, int begin, int end, int stride, const Rule& rule)
+{
+	if (rule.neighbourhood == 'N')
+		batchSpan<V, LANES>(above, row, below, out, begin, end, stride, ShapedRule<VonNeumannNeighbourhood, MaskRule>(rule));
+	else if (rule.neighbourhood == 'H')
+		batchSpan<V, LANES>(above, row, below, out, begin, end, stride, ShapedRule<HexagonalNeighbourhood, MaskRule>(rule));
+	else if (nonTotalistic(rule))
+		batchSpan<V, LANES>(above, row, below, out, begin, end, stride, henselRule(rule));
+	else if (sameCounts(rule, CONWAY))
+		batchSpan<V, LANES>(above, row, below, out, begin, end, stride, FixedRule<CONWAY.birth, CONWAY.survival>());
+	else
+		batchSpan<V, LANES>(above, row, below, out, begin, end, stride, MaskRule(rule));
+}
+
+static void scalarSpan(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths)
+{
+	ruleSpan<uint64_t, 1>(above, row, below, out, begin, end, rule, births, deaths);
+}
+
+static void scalarBatch(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, int stride, const Rule& rule)
+{
+	batchRuleSpan<uint64_t, 1>(above, row, below, out, begin, end, stride, rule);
+}
+
+#ifdef KERNELS_X86
+__attribute__((target("sse2")))
+static void sse2Span(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths)
+{
+	ruleSpan<vec128, 2>(above, row, below, out, begin, end, rule, births, deaths);
+}
+
+__attribute__((target("sse2")))
+static void sse2Batch(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, int stride, const Rule& rule)
+{
+	batchRuleSpan<vec128, 2>(above, row, below, out, begin, end, stride, rule);
+}
+
+__attribute__((target("avx2,popcnt")))
+static void avx2Span(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths)
+{
+	ruleSpan<vec256, 4>(above, row, below, out, begin, end, rule, births, deaths);
+}
+
+__attribute__((target("avx2,popcnt")))
+static void avx2Batch(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, int stride, const Rule& rule)
+{
+	batchRuleSpan<vec256, 4>(above, row, below, out, begin, end, stride, rule);
+}
+
+__attribute__((target("avx512f,avx2,popcnt")))
+static void avx512Span(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths)
+{
+	ruleSpan<vec512, 8>(above, row, below, out, begin, end, rule, births, deaths);
+}
+
+__attribute__((target("avx512f,avx2,popcnt")))
+static void avx512Batch(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, int stride, const Rule& rule)
+{
+	batchRuleSpan<vec512, 8>(above, row, below, out, begin, end, stride, rule);
+}
+#endif
+
+/* builds lifeTable() by counting the neighbours of the four centre cells of every block.
+ * The neighbours are gathered in the Rule neighbourhood numbering as well, for the
+ * exceptions of non-totalistic rules.
+ */
+static vector<uint8_t> buildLifeTable(const Rule& rule)
+{
+	vector<uint8_t> table(65536);
+	for (int block = 0; block < 65536; block++)
+	{
+		int next = 0;
+		for (int y = 1; y <= 2; y++)
+		{
+			for (int x = 1; x <= 2; x++)
+			{
+				int neighbours = 0, neighbourhood = 0, bit = 0;
+				for (int dy = -1; dy <= 1; dy++)
+					for (int dx = -1; dx <= 1; dx++)
+						if (dx != 0 || dy != 0)
+						{
+							//cells outside a smaller neighbourhood are never counted, but keep their bit in the numbering
+							int cell = inNeighbourhood(rule, dy, dx) ? (block >> ((y + dy) * 4 + x + dx)) & 1 : 0;
+							neighbours += cell;
+							neighbourhood |= cell << bit++;
+						}
+				bool alive = (block >> (y * 4 + x)) & 1;
+				neighbourhood |= alive << 8;
+				if ((((alive ? rule.survival : rule.birth) >> neighbours) ^ (rule.exceptions[neighbourhood >> 6] >> (neighbourhood & 63))) & 1)
+					next |= 1 << ((y - 1) * 2 + (x - 1));
+			}
+		}
+		table[block] = next;
+	}
+	return table;
+}
+
+//the next generation of the centre 2x2 cells of every 4x4 block under the given rule
+const uint8_t* lifeTable(const Rule& rule)
+{
+	static mutex lock;									//guards tables
+	static map<array<uint64_t, 9>, vector<uint8_t>> tables;	//every table built so far, by rule
+	//the same rule is asked for over and over, so each thread remembers the last one
+	static thread_local array<uint64_t, 9> lastKey = {0xffffffff};
+	static thread_local const uint8_t * lastTable = nullptr;
+
+	//the masks, the neighbourhood and the exceptions of non-totalistic rules
+	array<uint64_t, 9> key;
+	key[0] = ((uint64_t)(uint8_t)rule.neighbourhood << 32) | ((uint64_t)rule.birth << 16) | rule.survival;
+	for (int i = 0; i < 8; i++)
+		key[i + 1] = rule.exceptions[i];
+	if (key != lastKey)
+	{
+		lock_guard<mutex> guard(lock);
+		vector<uint8_t>& table = tables[key];
+		if (table.empty())
+			table = buildLifeTable(rule);
+		lastTable = table.data();
+		lastKey = key;
+	}
+	return lastTable;
+}
+
+//the next generation of one word of cells under any rule, for the words the row kernels leave out
+uint64_t ruleWord(const Rule& rule, uint64_t aW, uint64_t a, uint64_t aE,
+	uint64_t bW, uint64_t b, uint64_t bE, uint64_t cW, uint64_t c, uint64_t cE)
+{
+	if (rule.neighbourhood == 'N')
+		return ShapedRule<VonNeumannNeighbourhood, MaskRule>(rule).word(aW, a, aE, bW, b, bE, cW, c, cE);
+	if (rule.neighbourhood == 'H')
+		return ShapedRule<HexagonalNeighbourhood, MaskRule>(rule).word(aW, a, aE, bW, b, bE, cW, c, cE);
+	if (nonTotalistic(rule))
+		return henselRule(rule).word(aW, a, aE, bW, b, bE, cW, c, cE);
+	if (sameCounts(rule, CONWAY))
+		return lifeWord(aW, a, aE, bW, b, bE, cW, c, cE);
+	return MaskRule(rule).word(aW, a, aE, bW, b, bE, cW, c, cE);
+}
+
+/* the lookup table kernel: every word is built two cells at a time from the columns
+ * around them, read out of lifeTable() instead of counted. A row kernel only has the
+ * three rows around its row, so the fourth row of each block is left empty and only the
+ * top half of the 2x2 answer is used; that keeps the lookups in the first 4096 entries,
+ * which stay in the L1 cache.
+ */
+static void lutSpan(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths)
+{
+	const uint8_t * table = lifeTable(rule);
+	const uint64_t * rows[3] = {above, row, below};
+	for (int i = begin; i < end; i++)
+	{
+		//bit j of shifted[k] is column j - 1 of the word, so bits [c, c + 4) are the columns around c and c + 1
+		uint64_t shifted[3], tail = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			shifted[k] = (rows[k][i] << 1) | (rows[k][i - 1] >> 63);
+			//columns 61 to 64 of the word, for the last pair
+			tail |= ((rows[k][i] >> 61) | ((rows[k][i + 1] & 1) << 3)) << (k * 4);
+		}
+		uint64_t next = 0;
+		for (int c = 0; c < 62; c += 2)
+		{
+			int block = ((shifted[0] >> c) & 15) | (((shifted[1] >> c) & 15) << 4) | (((shifted[2] >> c) & 15) << 8);
+			next |= (uint64_t)(table[block] & 3) << c;
+		}
+		next |= (uint64_t)(table[tail] & 3) << 62;
+		births += __builtin_popcountll(next & ~row[i]);
+		deaths += __builtin_popcountll(row[i] & ~next);
+		out[i] = next;
+	}
+}
+
+static const KernelInfo scalarInfo = {"scalar", 1, scalarSpan, scalarBatch};
+//a lookup table does not help boards stored side by side, whose cells are whole words already
+static const KernelInfo lutInfo = {"LUT", 1, lutSpan, scalarBatch};
+
+#ifdef KERNELS_X86
+static const KernelInfo sse2Info = {"SSE2", 2, sse2Span, sse2Batch};
+static const KernelInfo avx2Info = {"AVX2", 4, avx2Span, avx2Batch};
+static const KernelInfo avx512Info = {"AVX-512", 8, avx512Span, avx512Batch};
+#endif
+
+//every kernel the cpu can run, for benchmarks
+vector<const KernelInfo*> availableKernels()
+{
+	vector<const KernelInfo*> kernels;
+	kernels.push_back(&scalarInfo);
+	kernels.push_back(&lutInfo);
+#ifdef KERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		kernels.push_back(&sse2Info);
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+		kernels.push_back(&avx2Info);
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt"))
+		kernels.push_back(&avx512Info);
+#endif
+	return kernels;
+}
+
+//asks the cpu which instruction sets it supports and returns the widest kernel available
+static const KernelInfo& detectKernel()
+{
+	//availableKernels() lists the SIMD kernels last, narrowest first
+	const KernelInfo * widest = availableKernels().back();
+	return (widest->lanes > 1) ? *widest : scalarInfo;
+}
+
+//the widest kernel the cpu supports, picked once at startup
+const KernelInfo& activeKernel()
+{
+	static const KernelInfo& kernel = detectKernel();
+	return kernel;
+}
+
+//the portable kernel, always available
+const KernelInfo& scalarKernel()
+{
+	return scalarInfo;
+}
+
+//the lookup table kernel, always available
+const KernelInfo& lutKernel()
+{
+	return lutInfo;
+}
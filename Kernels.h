@@ -0,0 +1,310 @@
+//Header file for the generation kernels
+#ifndef KERNELS_H_
+#define KERNELS_H_
+
+#include <cstdint>
+#include <vector>
+#include "Rule.h"
+
+/* a row kernel computes the words [begin, end) of the next generation of a packed row
+ * under the given rule. above, row and below are the three rows around the row being
+ * computed. Every word in the range must have a neighbouring word on both sides, so the
+ * first and last word of a row (which depend on the board edges) are left to the caller.
+ */
+typedef void (*RowKernel)(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, const Rule& rule, int& births, int& deaths);
+
+/* a batch kernel computes the words [begin, end) of the next generation of a row of cells
+ * that are stored stride words apart, each bit of a word being a different board (see
+ * BatchEngine). The neighbours of a word are then whole words, the words stride before and
+ * after it and the same words of the rows above and below, so nothing is shifted.
+ */
+typedef void (*BatchKernel)(const uint64_t* above, const uint64_t* row, const uint64_t* below,
+	uint64_t* out, int begin, int end, int stride, const Rule& rule);
+
+struct KernelInfo
+{
+	const char* name;	//name of the instruction set the kernel uses
+	int lanes;			//number of 64-bit words handled per instruction
+	RowKernel kernel;	//the kernel itself
+	BatchKernel batch;	//the same instruction set stepping boards stored side by side
+};
+
+const KernelInfo& activeKernel();	//the widest kernel the cpu supports, picked once at startup
+const KernelInfo& scalarKernel();	//the portable kernel, always available
+const KernelInfo& lutKernel();		//the lookup table kernel, always available
+std::vector<const KernelInfo*> availableKernels();	//every kernel the cpu can run, for benchmarks
+
+/* the next generation of the centre 2x2 cells of every 4x4 block (65536 entries) under
+ * the given rule. Bit y * 4 + x of the index is the cell at (x, y), bit (y - 1) * 2 + (x - 1)
+ * of the entry is the centre cell at (x, y). Tables are built once per rule and kept.
+ */
+const uint8_t* lifeTable(const Rule& rule);
+
+//the next generation of one word of cells under any rule, for the words the row kernels leave out
+uint64_t ruleWord(const Rule& rule, uint64_t aW, uint64_t a, uint64_t aE,
+	uint64_t bW, uint64_t b, uint64_t bE, uint64_t cW, uint64_t c, uint64_t cE);
+
+/* adds three bit-planes together, giving the low and high bit of the sum
+ * (a full adder applied to every bit of the word at once)
+ */
+template <typename V>
+inline __attribute__((always_inline)) V fullAdd(const V& a, const V& b, const V& c, V& hi)
+{
+	V t = a ^ b;
+	hi = (a & b) | (t & c);
+	return t ^ c;
+}
+
+/* computes the next generation of one word (or vector of words) of cells from the
+ * eight neighbour planes and the current cells. Works for uint64_t as well as the
+ * wider vector types, so every kernel shares the same rule logic.
+ */
+template <typename V>
+inline __attribute__((always_inline)) V lifeWord(const V& aW, const V& a, const V& aE, const V& bW, const V& b, const V& bE, const V& cW, const V& c, const V& cE)
+{
+	//sum the 8 neighbours as a 3-bit number (a count of 8 reads as 0, which is dead either way)
+	V a0, a1, c0, c1, k0, t0, t1;
+	a0 = fullAdd(aW, a, aE, a1);
+	c0 = fullAdd(cW, c, cE, c1);
+	V m0 = bW ^ bE;
+	V m1 = bW & bE;
+	V s0 = fullAdd(a0, c0, m0, k0);
+	t0 = fullAdd(a1, c1, m1, t1);
+	V s1 = t0 ^ k0;
+	V s2 = t1 ^ (t0 & k0);
+
+	//born with exactly 3 neighbours, survives with 2 or 3
+	return s1 & ~s2 & (s0 | b);
+}
+
+/* sums the 8 neighbour planes into a 4-bit count per cell, s0 being the lowest bit.
+ * Unlike lifeWord() this tells 0 and 8 neighbours apart, which other rules need.
+ */
+template <typename V>
+inline __attribute__((always_inline)) void countNeighbours(const V& aW, const V& a, const V& aE, const V& bW, const V& bE, const V& cW, const V& c, const V& cE,
+	V& s0, V& s1, V& s2, V& s3)
+{
+	V a0, a1, c0, c1, k0, t0, t1;
+	a0 = fullAdd(aW, a, aE, a1);
+	c0 = fullAdd(cW, c, cE, c1);
+	V m0 = bW ^ bE;
+	V m1 = bW & bE;
+	s0 = fullAdd(a0, c0, m0, k0);
+	t0 = fullAdd(a1, c1, m1, t1);
+	s1 = t0 ^ k0;
+	V carry = t0 & k0;
+	s2 = t1 ^ carry;
+	s3 = t1 & carry;
+}
+
+//all ones where the count is N (checked at compile time, so only the matching planes are kept)
+template <int N, typename V>
+inline __attribute__((always_inline)) V countIs(const V& s0, const V& s1, const V& s2, const V& s3)
+{
+	return ((N & 1) ? s0 : ~s0) & ((N & 2) ? s1 : ~s1) & ((N & 4) ? s2 : ~s2) & ((N & 8) ? s3 : ~s3);
+}
+
+//all ones where the count is one of the counts in MASK, starting from count N
+template <int MASK, int N = 0>
+struct CountMatch
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) V get(const V& s0, const V& s1, const V& s2, const V& s3)
+	{
+		V rest = CountMatch<MASK, N + 1>::get(s0, s1, s2, s3);
+		return ((MASK >> N) & 1) ? (rest | countIs<N>(s0, s1, s2, s3)) : rest;
+	}
+};
+
+template <int MASK>
+struct CountMatch<MASK, 9>
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) V get(const V& s0, const V&, const V&, const V&)
+	{
+		return s0 & ~s0;
+	}
+};
+
+/* a rule known at compile time: the births and survivals are fixed masks, so the
+ * compiler reduces the count checks to the handful of bit operations the rule needs
+ */
+template <int BIRTH, int SURVIVAL>
+struct FixedRule
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) V word(const V& aW, const V& a, const V& aE, const V& bW, const V& b, const V& bE, const V& cW, const V& c, const V& cE)
+	{
+		V s0, s1, s2, s3;
+		countNeighbours(aW, a, aE, bW, bE, cW, c, cE, s0, s1, s2, s3);
+		return (CountMatch<BIRTH>::get(s0, s1, s2, s3) & ~b) | (CountMatch<SURVIVAL>::get(s0, s1, s2, s3) & b);
+	}
+};
+
+//B3/S23 keeps the 3-bit count of lifeWord(), which is all it needs
+template <>
+struct FixedRule<1 << 3, (1 << 2) | (1 << 3)>
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) V word(const V& aW, const V& a, const V& aE, const V& bW, const V& b, const V& bE, const V& cW, const V& c, const V& cE)
+	{
+		return lifeWord(aW, a, aE, bW, b, bE, cW, c, cE);
+	}
+};
+
+/* any rule, read at runtime: every count from 0 to 8 is checked against a mask
+ * that is all ones if the count gives a birth (or lets a cell survive)
+ */
+struct MaskRule
+{
+	uint64_t birth[9];		//all ones if a dead cell with n neighbours is born
+	uint64_t survival[9];	//all ones if a live cell with n neighbours survives
+
+	MaskRule(const Rule& rule)
+	{
+		for (int n = 0; n < 9; n++)
+		{
+			birth[n] = ((rule.birth >> n) & 1) ? ~(uint64_t)0 : 0;
+			survival[n] = ((rule.survival >> n) & 1) ? ~(uint64_t)0 : 0;
+		}
+	}
+
+	template <typename V>
+	inline __attribute__((always_inline)) V word(const V& aW, const V& a, const V& aE, const V& bW, const V& b, const V& bE, const V& cW, const V& c, const V& cE) const
+	{
+		V s0, s1, s2, s3;
+		countNeighbours(aW, a, aE, bW, bE, cW, c, cE, s0, s1, s2, s3);
+		V next = b & ~b;
+		for (int n = 0; n < 9; n++)
+		{
+			V is = ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) & ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+			next |= is & ((~b & birth[n]) | (b & survival[n]));
+		}
+		return next;
+	}
+};
+
+/* neighbourhood policies: keep() clears the planes of the cells outside the neighbourhood.
+ * The cleared planes are known to be zero at compile time, so the adders that count the
+ * neighbours shrink to the cells that are left.
+ */
+struct MooreNeighbourhood
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) void keep(V&, V&, V&, V&, V&, V&, V&, V&)
+	{
+	}
+};
+
+//n, w, e and s only
+struct VonNeumannNeighbourhood
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) void keep(V& aW, V&, V& aE, V&, V&, V& cW, V&, V& cE)
+	{
+		aW = aE = cW = cE = aW & ~aW;
+	}
+};
+
+//every cell but ne and sw, a hexagonal grid drawn skewed on the square one
+struct HexagonalNeighbourhood
+{
+	template <typename V>
+	static inline __attribute__((always_inline)) void keep(V&, V&, V& aE, V&, V&, V& cW, V&, V&)
+	{
+		aE = cW = aE & ~aE;
+	}
+};
+
+//a rule run on a smaller neighbourhood than the Moore one
+template <typename SHAPE, typename RULE>
+struct ShapedRule
+{
+	RULE rule;		//the rule, counting only the neighbours SHAPE keeps
+
+	ShapedRule(const RULE& rule) : rule(rule)
+	{
+	}
+
+	template <typename V>
+	inline __attribute__((always_inline)) V word(const V& aW, const V& a, const V& aE, const V& bW, const V& b, const V& bE, const V& cW, const V& c, const V& cE) const
+	{
+		V nw = aW, n = a, ne = aE, w = bW, e = bE, sw = cW, s = c, se = cE;
+		SHAPE::keep(nw, n, ne, w, e, sw, s, se);
+		return rule.template word<V>(nw, n, ne, w, b, e, sw, s, se);
+	}
+};
+
+/* a non-totalistic rule, read at runtime: MaskRule gives what the counts alone say, and
+ * the exceptions are flipped on top of that. Neighbourhood i has its low 4 bits (nw, n,
+ * ne, w) in one of 16 groups and its high 5 bits (e, sw, s, se, centre) in one of 32, and
+ * each high group's 16 exception bits say which low groups to flip. So a plane is built
+ * for each of the 16 low groups once, and every high group with exceptions costs one
+ * and of its 5 cells with the or of its flipped low planes. Most rules only have
+ * exceptions in a few high groups, with a few low groups each.
+ */
+struct HenselRule
+{
+	struct Group
+	{
+		uint8_t high;		//the high group
+		uint8_t count;		//number of low groups in low
+		bool invert;		//low lists the low groups that are not flipped, there were fewer of them
+		uint8_t low[8];		//the low groups that are flipped (or not, if invert is set)
+	};
+
+	MaskRule masks;			//the totalistic part of the rule
+	int groups;				//number of high groups with exceptions
+	Group group[32];		//the high groups with exceptions
+
+	HenselRule(const Rule& rule) : masks(rule)
+	{
+		groups = 0;
+		for (int i = 0; i < 32; i++)
+		{
+			uint16_t bits = rule.exceptions[i >> 2] >> ((i & 3) * 16);
+			if (!bits)
+				continue;
+			Group& g = group[groups++];
+			g.high = i;
+			g.count = 0;
+			g.invert = __builtin_popcount(bits) > 8;
+			if (g.invert)
+				bits = ~bits;
+			for (int j = 0; j < 16; j++)
+				if ((bits >> j) & 1)
+					g.low[g.count++] = j;
+		}
+	}
+
+	template <typename V>
+	inline __attribute__((always_inline)) V word(const V& aW, const V& a, const V& aE, const V& bW, const V& b, const V& bE, const V& cW, const V& c, const V& cE) const
+	{
+		V next = masks.word(aW, a, aE, bW, b, bE, cW, c, cE);
+		//the low groups, from pairs of cells: nw and n, then ne and w
+		V first[4] = {~aW & ~a, aW & ~a, ~aW & a, aW & a};
+		V second[4] = {~aE & ~bW, aE & ~bW, ~aE & bW, aE & bW};
+		V low[16];
+		for (int j = 0; j < 16; j++)
+			low[j] = first[j & 3] & second[j >> 2];
+		//the high groups: e and sw, s and se, then the centre
+		V third[4] = {~bE & ~cW, bE & ~cW, ~bE & cW, bE & cW};
+		V fourth[4] = {~c & ~cE, c & ~cE, ~c & cE, c & cE};
+		V centre[2] = {~b, b};
+		V flip = b & ~b;
+		for (int i = 0; i < groups; i++)
+		{
+			const Group& g = group[i];
+			V any = low[g.low[0]];
+			for (int j = 1; j < g.count; j++)
+				any |= low[g.low[j]];
+			if (g.invert)
+				any = ~any;
+			flip |= third[g.high & 3] & fourth[(g.high >> 2) & 3] & centre[g.high >> 4] & any;
+		}
+		return next ^ flip;
+	}
+};
+
+#endif /* KERNELS_H_ */
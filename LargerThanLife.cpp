@@ -0,0 +1,240 @@
+#include "LargerThanLife.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+LargerThanLife::LargerThanLife()
+{
+	paddedHeight = 0;
+	paddedWidth = 0;
+}
+
+//fills padded rows [first, last) from the packed board
+void LargerThanLife::unpackRows(const uint64_t * cells, int wordsPerRow, int height, int width, Topology topology,
+	int range, int first, int last)
+{
+	for (int i = first; i < last; i++)
+	{
+		uint8_t * out = &padded[i * (size_t)paddedWidth];
+		int r = i - range;
+		bool inside = r >= 0 && r < height;
+		for (int j = 0; j < paddedWidth; j++)
+		{
+			int c = j - range;
+			int y = r, x = c;
+			//the margin holds whatever the topology puts past the edges
+			if (!inside || c < 0 || c >= width)
+			{
+				if (!topologyCell(topology, y, x, height, width))
+				{
+					out[j] = 0;
+					continue;
+				}
+			}
+			out[j] = (cells[y * (size_t)wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+		}
+	}
+}
+
+/* fills upRight and downRight rows [first, last). Both are running sums along their
+ * diagonal: the first row of the range is summed cell by cell, every row after it takes
+ * the diagonal sum from the row above and swaps one cell at either end.
+ */
+void LargerThanLife::diagonalRows(int range, int first, int last)
+{
+	const long stride = paddedWidth;
+	for (int i = first; i < last; i++)
+	{
+		const uint8_t * cell = &padded[i * stride];
+		uint8_t * up = &upRight[i * stride];
+		uint8_t * down = &downRight[i * stride];
+		for (int j = 0; j < paddedWidth; j++)
+		{
+			if (i == first || j == 0)
+			{
+				int upSum = 0, downSum = 0;
+				for (int k = 0; k <= range; k++)
+				{
+					if (i - k >= 0 && j + k < paddedWidth)
+						upSum += cell[j + k - k * stride];
+					if (i + k < paddedHeight && j + k < paddedWidth)
+						downSum += cell[j + k + k * stride];
+				}
+				up[j] = upSum;
+				down[j] = downSum;
+				continue;
+			}
+			//up: drops the cell range + 1 rows up, down: drops the cell just above and to the left
+			int upSum = cell[j];
+			if (j + 1 < paddedWidth)
+				upSum += up[j + 1 - stride];
+			if (i - range - 1 >= 0 && j + range + 1 < paddedWidth)
+				upSum -= cell[j + range + 1 - (range + 1) * stride];
+			int downSum = down[j - 1 - stride] - cell[j - 1 - stride];
+			if (i + range < paddedHeight && j + range < paddedWidth)
+				downSum += cell[j + range + range * stride];
+			up[j] = upSum;
+			down[j] = downSum;
+		}
+	}
+}
+
+//computes board rows [first, last), Moore neighbourhood
+void LargerThanLife::mooreRows(const uint64_t * cells, uint64_t * next, int wordsPerRow, int width, const Rule& rule,
+	vector<int>& sums, int first, int last, int& born, int& died)
+{
+	const int range = rule.range;
+	const int span = 2 * range + 1;
+	const size_t stride = paddedWidth;
+	//board row r is padded row r + range, so its column sums start at padded row r
+	sums.assign(paddedWidth, 0);
+	for (int i = first; i < first + span; i++)
+		for (int j = 0; j < paddedWidth; j++)
+			sums[j] += padded[i * stride + j];
+
+	for (int r = first; r < last; r++)
+	{
+		const uint8_t * centre = &padded[(r + range) * stride + range];
+		const uint64_t * old = cells + r * (size_t)wordsPerRow;
+		uint64_t * out = next + r * (size_t)wordsPerRow;
+		int sum = 0;
+		for (int j = 0; j < span; j++)
+			sum += sums[j];
+		uint64_t word = 0;
+		for (int c = 0; c < width; c++)
+		{
+			if (c > 0)
+				sum += sums[c + span - 1] - sums[c - 1];
+			int alive = centre[c];
+			int count = sum - alive;
+			bool living = alive ? (count >= rule.survivalMin && count <= rule.survivalMax) :
+				(count >= rule.birthMin && count <= rule.birthMax);
+			word |= (uint64_t)living << (c & 63);
+			if ((c & 63) == 63 || c == width - 1)
+			{
+				born += __builtin_popcountll(word & ~old[c >> 6]);
+				died += __builtin_popcountll(old[c >> 6] & ~word);
+				out[c >> 6] = word;
+				word = 0;
+			}
+		}
+		//slide the column sums down a row
+		if (r + 1 < last)
+		{
+			const uint8_t * leaving = &padded[r * stride];
+			const uint8_t * entering = &padded[(r + span) * stride];
+			for (int j = 0; j < paddedWidth; j++)
+				sums[j] += entering[j] - leaving[j];
+		}
+	}
+}
+
+/* computes board rows [first, last), von Neumann neighbourhood. The diamond around the
+ * first cell of a row is summed cell by cell. Moving it right by one drops its west
+ * edge, the runs going up and down and right from its westernmost cell, and adds the
+ * new east edge, the runs going down and up and right from its northernmost and
+ * southernmost cells to its easternmost one.
+ */
+void LargerThanLife::vonNeumannRows(const uint64_t * cells, uint64_t * next, int wordsPerRow, int width,
+	const Rule& rule, int first, int last, int& born, int& died)
+{
+	const int range = rule.range;
+	const long stride = paddedWidth;
+	for (int r = first; r < last; r++)
+	{
+		const long y = (r + range) * stride;
+		const uint8_t * cell = &padded[y];
+		const uint8_t * up = &upRight[y];
+		const uint8_t * down = &downRight[y];
+		const uint8_t * north = &downRight[y - range * stride];
+		const uint8_t * south = &upRight[y + range * stride];
+		const uint64_t * old = cells + r * (size_t)wordsPerRow;
+		uint64_t * out = next + r * (size_t)wordsPerRow;
+		int sum = 0;
+		for (int dy = -range; dy <= range; dy++)
+		{
+			int reach = range - ((dy < 0) ? -dy : dy);
+			for (int dx = -reach; dx <= reach; dx++)
+				sum += cell[range + dx + dy * stride];
+		}
+		uint64_t word = 0;
+		for (int c = 0; c < width; c++)
+		{
+			//in padded columns the cell is at c + range, so its west edge starts at column c - 1
+			if (c > 0)
+				sum += north[c + range] + south[c + range] - cell[c + 2 * range] - (up[c - 1] + down[c - 1] - cell[c - 1]);
+			int alive = cell[c + range];
+			int count = sum - alive;
+			bool living = alive ? (count >= rule.survivalMin && count <= rule.survivalMax) :
+				(count >= rule.birthMin && count <= rule.birthMax);
+			word |= (uint64_t)living << (c & 63);
+			if ((c & 63) == 63 || c == width - 1)
+			{
+				born += __builtin_popcountll(word & ~old[c >> 6]);
+				died += __builtin_popcountll(old[c >> 6] & ~word);
+				out[c >> 6] = word;
+				word = 0;
+			}
+		}
+	}
+}
+
+/* computes the next generation of cells into next, split into the given number of row stripes.
+ * The padded cells (and the diagonal sums) are filled in first, each pass spread over the
+ * stripes, then every stripe computes its rows from them.
+ */
+void LargerThanLife::step(const uint64_t * cells, uint64_t * next, int height, int width, int wordsPerRow,
+	Topology topology, const Rule& rule, int stripes, long long& births, long long& deaths)
+{
+	const int range = rule.range;
+	paddedHeight = height + 2 * range;
+	paddedWidth = width + 2 * range;
+	const size_t size = paddedHeight * (size_t)paddedWidth;
+	padded.resize(size);
+	stripes = (stripes < height) ? stripes : height;
+	stripes = (stripes > 0) ? stripes : 1;
+	stripeBirths.assign(stripes, 0);
+	stripeDeaths.assign(stripes, 0);
+
+	auto unpack = [&](int i)
+	{
+		unpackRows(cells, wordsPerRow, height, width, topology, range,
+			paddedHeight * (long long)i / stripes, paddedHeight * (long long)(i + 1) / stripes);
+	};
+	ThreadPool::shared().run(unpack, stripes);
+
+	if (rule.neighbourhood == 'N')
+	{
+		upRight.resize(size);
+		downRight.resize(size);
+		auto diagonals = [&](int i)
+		{
+			diagonalRows(range, paddedHeight * (long long)i / stripes, paddedHeight * (long long)(i + 1) / stripes);
+		};
+		ThreadPool::shared().run(diagonals, stripes);
+		auto stripe = [&](int i)
+		{
+			vonNeumannRows(cells, next, wordsPerRow, width, rule, height * (long long)i / stripes,
+				height * (long long)(i + 1) / stripes, stripeBirths[i], stripeDeaths[i]);
+		};
+		ThreadPool::shared().run(stripe, stripes);
+	}
+	else
+	{
+		if ((int)columnSums.size() < stripes)
+			columnSums.resize(stripes);
+		auto stripe = [&](int i)
+		{
+			mooreRows(cells, next, wordsPerRow, width, rule, columnSums[i], height * (long long)i / stripes,
+				height * (long long)(i + 1) / stripes, stripeBirths[i], stripeDeaths[i]);
+		};
+		ThreadPool::shared().run(stripe, stripes);
+	}
+
+	//summed in stripe order, so the totals never depend on which thread finished first
+	for (int i = 0; i < stripes; i++)
+	{
+		births += stripeBirths[i];
+		deaths += stripeDeaths[i];
+	}
+}
@@ -0,0 +1,49 @@
+//Header file for the Larger than Life generation step
+#ifndef LARGERTHANLIFE_H_
+#define LARGERTHANLIFE_H_
+
+#include <cstdint>
+#include <vector>
+#include "Rule.h"
+#include "Topology.h"
+
+/* computes generations of a packed board under a Larger than Life rule (any range up
+ * to MAX_RANGE). Counting every neighbour would cost O(range^2) per cell, so the counts
+ * come from running sums instead and cost the same for every range:
+ * - Moore: every column keeps the sum of its 2 * range + 1 cells around the current
+ *   row, and a window of 2 * range + 1 column sums slides along the row.
+ * - von Neumann: the diamond slides along the row as well. Moving it one cell to the
+ *   right loses its west edge and gains a new east edge, and each edge is two diagonal
+ *   runs of range + 1 cells, which are themselves running sums kept per generation.
+ * The cells are first unpacked one per byte with a margin of range cells around the
+ * board (whatever the topology puts past the edges), so no sum ever has to check for
+ * the edge. The buffers are kept between generations.
+ */
+class LargerThanLife
+{
+	std::vector<uint8_t> padded;			//the cells one per byte, with a margin of range cells all round
+	std::vector<uint8_t> upRight;			//von Neumann: the sum of range + 1 cells going up and right from each cell
+	std::vector<uint8_t> downRight;			//von Neumann: the sum of range + 1 cells going down and right from each cell
+	std::vector<std::vector<int>> columnSums;	//Moore: each stripe's sums of 2 * range + 1 cells down each column
+	std::vector<int> stripeBirths;			//births counted by each stripe during the last generation
+	std::vector<int> stripeDeaths;			//deaths counted by each stripe during the last generation
+	int paddedHeight;						//height of padded
+	int paddedWidth;						//width of padded
+
+	void unpackRows(const uint64_t * cells, int wordsPerRow, int height, int width, Topology topology,
+		int range, int first, int last);	//fills padded rows [first, last) from the packed board
+	void diagonalRows(int range, int first, int last);	//fills upRight and downRight rows [first, last)
+	void mooreRows(const uint64_t * cells, uint64_t * next, int wordsPerRow, int width, const Rule& rule,
+		std::vector<int>& sums, int first, int last, int& born, int& died);	//computes board rows [first, last), Moore neighbourhood
+	void vonNeumannRows(const uint64_t * cells, uint64_t * next, int wordsPerRow, int width, const Rule& rule,
+		int first, int last, int& born, int& died);		//computes board rows [first, last), von Neumann neighbourhood
+
+public:
+	LargerThanLife();
+
+	//computes the next generation of cells into next, split into the given number of row stripes
+	void step(const uint64_t * cells, uint64_t * next, int height, int width, int wordsPerRow, Topology topology,
+		const Rule& rule, int stripes, long long& births, long long& deaths);
+};
+
+#endif /* LARGERTHANLIFE_H_ */
@@ -0,0 +1,282 @@
+#include "Library.h"
+#include "Formats.h"
+#include "Objects.h"
+#include "Rule.h"
+#include "ThreadPool.h"
+#include "Util.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <sys/stat.h>
+#include <unordered_map>
+
+using namespace std;
+
+const long long PatternLibrary::MAX_CELLS;
+const int PatternLibrary::VERSION;
+
+//the extensions of the files loadFormat() reads
+static const char * const PATTERN_EXTENSIONS[] = {".rle", ".life", ".lif", ".brd", ".brd2", ".cells", ".mc"};
+
+//the index as the cache left it, refresh() brings it up to date
+PatternLibrary::PatternLibrary(string folder)
+{
+	this->folder = folder;
+	readCache();
+}
+
+//returns the path of the cache file
+string PatternLibrary::cachePath()
+{
+	return folder + separator() + ".library";
+}
+
+//returns the path of a pattern's file
+string PatternLibrary::path(const LibraryEntry& entry)
+{
+	return folder + separator() + entry.name;
+}
+
+/* reads the entries from the cache file, none if it is missing or from another version
+The file is a version line, then a line of tab separated fields for every entry followed by
+its comments, a line each.*/
+void PatternLibrary::readCache()
+{
+	entries.clear();
+	ifstream in(cachePath());
+	string line;
+	if (!getline(in, line) || line != "GameOfGenes library " + to_string(VERSION))
+		return;
+	while (getline(in, line))
+	{
+		vector<string> fields;
+		stringstream stream(line);
+		string field;
+		while (getline(stream, field, '\t'))
+			fields.push_back(field);
+		if (fields.size() < 9)
+			break;
+		LibraryEntry entry;
+		entry.name = fields[0];
+		entry.modified = atoll(fields[1].c_str());
+		entry.bytes = atoll(fields[2].c_str());
+		entry.height = atoi(fields[3].c_str());
+		entry.width = atoi(fields[4].c_str());
+		entry.population = atoll(fields[5].c_str());
+		entry.hash = strtoull(fields[6].c_str(), nullptr, 16);
+		entry.rule = fields[7];
+		int comments = atoi(fields[8].c_str());
+		entry.error = (fields.size() > 9) ? fields[9] : "";
+		for (int i = 0; i < comments && getline(in, line); i++)
+			entry.comments.push_back(line);
+		entries.push_back(entry);
+	}
+}
+
+//writes the entries to the cache file, all at once
+void PatternLibrary::writeCache()
+{
+	string out = "GameOfGenes library " + to_string(VERSION) + "\n";
+	char hash[17];
+	for (auto& entry : entries)
+	{
+		snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)entry.hash);
+		out += entry.name + "\t" + to_string(entry.modified) + "\t" + to_string(entry.bytes) + "\t" +
+			to_string(entry.height) + "\t" + to_string(entry.width) + "\t" + to_string(entry.population) + "\t" +
+			hash + "\t" + entry.rule + "\t" + to_string(entry.comments.size()) + "\t" + entry.error + "\n";
+		for (auto& comment : entry.comments)
+			out += comment + "\n";
+	}
+	ofstream file(cachePath(), ios::binary);
+	file.write(out.data(), out.size());
+}
+
+/* the comment lines at the top of a pattern file: #C, #N, #O and #D lines of RLE, Life and
+macrocell files and ! lines of plaintext ones, without their tag. The header lines among
+them (#R, #G, [M2]...) are skipped, and the first line of cells ends them.*/
+static vector<string> readComments(const string& path)
+{
+	vector<string> comments;
+	ifstream in(path, ios::binary);
+	string line;
+	while (getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (line.empty() || (line[0] != '#' && line[0] != '!' && line[0] != '['))
+			break;
+		string text;
+		if (line[0] == '!')
+			text = line.substr(1);
+		else if (line.size() >= 2 && line[0] == '#' && string("CcNOD").find(line[1]) != string::npos)
+			text = line.substr(2);
+		else
+			continue;
+		size_t start = text.find_first_not_of(" \t");
+		if (start != string::npos)
+			comments.push_back(text.substr(start));
+	}
+	return comments;
+}
+
+//reads the size and rule on the header line of an RLE file, false if it has none
+static bool readRLEHeader(const string& path, long long& height, long long& width, string& rule)
+{
+	ifstream in(path, ios::binary);
+	string line;
+	while (getline(in, line))
+	{
+		if (line.empty() || line[0] == '#' || line[0] == '\r')
+			continue;
+		if (sscanf(line.c_str(), "x = %lld, y = %lld", &width, &height) != 2)
+			return false;
+		size_t equals = line.find('=', line.find("rule"));
+		rule = (line.find("rule") == string::npos || equals == string::npos) ? "B3/S23" : line.substr(equals + 1);
+		rule.erase(remove_if(rule.begin(), rule.end(), ::isspace), rule.end());
+		return true;
+	}
+	return false;
+}
+
+/* loads a file and fills in what it holds
+The file is only loaded as far as loadFormat() goes, no board is made, and the population and
+hash come from its live cells. An RLE file whose header promises a board of more than
+MAX_CELLS cells (a synthesis spread over half a million rows, say) is not loaded at all: its
+size, rule and comments are indexed from the header and its population and hash are left
+unknown.*/
+void PatternLibrary::index(LibraryEntry& entry)
+{
+	const string file = path(entry);
+	entry.comments = readComments(file);
+	entry.height = entry.width = 0;
+	entry.population = -1;
+	entry.hash = 0;
+	entry.rule = "";
+	entry.error = "";
+	try
+	{
+		long long height, width;
+		if (endsWith(entry.name, ".rle") && readRLEHeader(file, height, width, entry.rule) && height * width > MAX_CELLS)
+		{
+			entry.height = min(height, (long long)INT_MAX);
+			entry.width = min(width, (long long)INT_MAX);
+			return;
+		}
+		BoardData data = loadFormat(file);
+		vector<pair<int, int>> living = liveCells(data);
+		entry.height = data.height;
+		entry.width = data.width;
+		entry.rule = ruleString(makeRule(data.birthRule, data.survivalRule, data.range, data.neighbourhood, data.states,
+			data.transitions));
+		entry.population = living.size();
+		entry.hash = patternHash(living);
+	}
+	catch (const char * message)
+	{
+		entry.error = message;
+	}
+	catch (const bad_alloc&)
+	{
+		entry.error = "Out of memory";
+	}
+}
+
+/* indexes the new and changed files and forgets the deleted ones, returns how many files were loaded
+A file is loaded again if its time or size is not what the cache has. The files to load are
+handed out to every core a file at a time, the biggest first, so a huge pattern does not
+hold up the end. The cache is only written if something changed.*/
+int PatternLibrary::refresh()
+{
+	vector<LibraryEntry> found;
+	DIR * directory = opendir(folder.c_str());
+	if (directory == nullptr)
+		throw "The pattern folder cannot be opened";
+	while (dirent * item = readdir(directory))
+	{
+		string name = item->d_name;
+		bool pattern = false;
+		for (const char * extension : PATTERN_EXTENSIONS)
+			pattern |= endsWith(name, extension);
+		struct stat info;
+		if (!pattern || name[0] == '.' || stat((folder + separator() + name).c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+			continue;
+		LibraryEntry entry;
+		entry.name = name;
+		entry.modified = info.st_mtime;
+		entry.bytes = info.st_size;
+		found.push_back(entry);
+	}
+	closedir(directory);
+	sort(found.begin(), found.end(), [](const LibraryEntry& a, const LibraryEntry& b)
+	{
+		return a.name < b.name;
+	});
+
+	unordered_map<string, const LibraryEntry *> cached;
+	for (auto& entry : entries)
+		cached[entry.name] = &entry;
+	vector<int> stale;
+	for (size_t i = 0; i < found.size(); i++)
+	{
+		auto it = cached.find(found[i].name);
+		if (it != cached.end() && it->second->modified == found[i].modified && it->second->bytes == found[i].bytes)
+			found[i] = *it->second;
+		else
+			stale.push_back(i);
+	}
+	if (stale.empty() && found.size() == entries.size())
+		return 0;
+
+	sort(stale.begin(), stale.end(), [&](int a, int b)
+	{
+		return found[a].bytes > found[b].bytes;
+	});
+	ThreadPool& pool = ThreadPool::shared();
+	atomic<size_t> next(0);
+	auto task = [&](int)
+	{
+		size_t i;
+		while ((i = next.fetch_add(1)) < stale.size())
+			index(found[stale[i]]);
+	};
+	pool.run(task, pool.getThreads());
+	entries.swap(found);
+	writeCache();
+	return stale.size();
+}
+
+//returns every pattern, sorted by name
+const vector<LibraryEntry>& PatternLibrary::getEntries()
+{
+	return entries;
+}
+
+//lower case copy of a string
+static string lowered(string text)
+{
+	transform(text.begin(), text.end(), text.begin(), ::tolower);
+	return text;
+}
+
+//returns the entries whose name, rule or comments contain the text (whatever its case), all of them for ""
+vector<int> PatternLibrary::search(string text)
+{
+	text = lowered(text);
+	vector<int> matches;
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const LibraryEntry& entry = entries[i];
+		bool match = text.empty() || lowered(entry.name).find(text) != string::npos ||
+			lowered(entry.rule).find(text) != string::npos;
+		for (size_t j = 0; j < entry.comments.size() && !match; j++)
+			match = lowered(entry.comments[j]).find(text) != string::npos;
+		if (match)
+			matches.push_back(i);
+	}
+	return matches;
+}
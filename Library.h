@@ -0,0 +1,52 @@
+//Header file for the pattern library
+#ifndef LIBRARY_H_
+#define LIBRARY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//what the library knows about one pattern file
+struct LibraryEntry
+{
+	std::string name;					//the file name, without the folder
+	long long modified;					//when the file was last changed, as stat() tells it
+	long long bytes;					//size of the file
+	int height;							//height of the board the file loads as
+	int width;							//width of the board the file loads as
+	std::string rule;					//the rule, eg "B3/S23"
+	long long population;				//number of live cells, -1 if the board is too big to load
+	uint64_t hash;						//patternHash() of the live cells, the same wherever they lie and whichever way they face, 0 if not loaded
+	std::vector<std::string> comments;	//the comment lines at the top of the file
+	std::string error;					//why the file could not be loaded, empty if it was
+};
+
+/* an index of every pattern file in a folder (saved/), so the patterns can be listed and
+ * searched without loading a single one. The index is kept in one cache file in the folder
+ * and brought up to date by refresh(), which only loads the files that are new or have
+ * changed since (by their time and size), spread over every core. A folder of thousands of
+ * patterns is indexed once, after that opening the library costs reading the cache and
+ * looking at the times of the files.
+ */
+class PatternLibrary
+{
+	std::string folder;					//the folder the patterns are in
+	std::vector<LibraryEntry> entries;	//every pattern, sorted by name
+
+	std::string cachePath();			//returns the path of the cache file
+	void readCache();					//reads the entries from the cache file, none if it is missing or from another version
+	void writeCache();					//writes the entries to the cache file
+	void index(LibraryEntry& entry);	//loads a file and fills in what it holds
+
+public:
+	static const long long MAX_CELLS = 1LL << 31;	//bigger boards are only read as far as their header
+	static const int VERSION = 1;		//the version of the cache file
+
+	PatternLibrary(std::string folder = "saved");	//the index as the cache left it, refresh() brings it up to date
+	int refresh();						//indexes the new and changed files and forgets the deleted ones, returns how many files were loaded
+	const std::vector<LibraryEntry>& getEntries();	//returns every pattern, sorted by name
+	std::vector<int> search(std::string text);	//returns the entries whose name, rule or comments contain the text (whatever its case), all of them for ""
+	std::string path(const LibraryEntry& entry);	//returns the path of a pattern's file
+};
+
+#endif /* LIBRARY_H_ */
@@ -0,0 +1,432 @@
+#include "Macrocell.h"
+#include "Formats.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+const int Macrocell::LEAF_LEVEL;
+
+//hashes a node by its quadrants, or its cells for a leaf
+static uint64_t nodeHash(const uint32_t child[4], uint64_t cells, int level)
+{
+	uint64_t h = cells ^ level;
+	for (int i = 0; i < 4; i++)
+		h = (h ^ child[i]) * 0x9E3779B97F4A7C15ULL;
+	return h ^ (h >> 29);
+}
+
+//an empty pattern
+Macrocell::Macrocell()
+{
+	Node empty = {{0, 0, 0, 0}, 0, 0, 0};
+	nodes.assign(1, empty);
+	buckets.assign(1 << 10, 0);
+	root = 0;
+	rootLevel = LEAF_LEVEL + 1;
+	generation = 0;
+}
+
+/* reads a macrocell file
+After the "[M2]" line come '#' lines (#R is the rule, #G the generation, #C and #N comments)
+and then a node a line, each numbered by its position from 1: a leaf is its rows of '.'
+and '*', each ended by '$', and any other node is its level and the numbers of its four
+quadrants, 0 standing for an empty one. The last node is the root. The nodes are put
+through leaf() and join(), so a file that repeats a block ends up with it once.*/
+Macrocell::Macrocell(string filename): Macrocell()
+{
+	MappedFile file(filename);
+	const char * p = file.begin();
+	const char * end = file.end();
+	vector<uint32_t> ids(1, 0);		//the node every number in the file stands for
+	vector<int> levels(1, 0);		//the level of every number in the file
+	string line;
+	bool first = true;
+	while (p < end)
+	{
+		const char * eol = find(p, end, '\n');
+		const char * last = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+		if (first)
+		{
+			if (last - p < 4 || memcmp(p, "[M2]", 4) != 0)
+				throw "Error: Not a Macrocell File";
+			first = false;
+		}
+		else if (p < last && *p == '#')
+		{
+			line.assign(p, last);
+			if (line.compare(0, 3, "#R ") == 0)
+				rule = line.substr(3);
+			else if (line.compare(0, 3, "#G ") == 0)
+				generation = atoll(line.c_str() + 3);
+			else if (line.compare(0, 2, "#C") == 0 || line.compare(0, 2, "#N") == 0)
+				comments.push_back(line.substr(min((size_t)3, line.size())));
+		}
+		else if (p < last && (*p == '.' || *p == '*' || *p == '$'))
+		{
+			uint64_t cells = 0;
+			int r = 0, c = 0;
+			for (const char * q = p; q < last; q++)
+			{
+				if (*q == '$')
+				{
+					r++;
+					c = 0;
+					continue;
+				}
+				if (r >= 8 || c >= 8 || (*q != '.' && *q != '*'))
+					throw "Error: Bad Macrocell Leaf";
+				if (*q == '*')
+					cells |= (uint64_t)1 << (r * 8 + c);
+				c++;
+			}
+			ids.push_back(leaf(cells));
+			levels.push_back(LEAF_LEVEL);
+		}
+		else if (p < last)
+		{
+			line.assign(p, last);
+			int level;
+			unsigned long long child[4];
+			if (sscanf(line.c_str(), "%d %llu %llu %llu %llu", &level, &child[0], &child[1], &child[2], &child[3]) != 5)
+				throw "Error: Bad Macrocell Node";
+			//files with more than two states have level 1 nodes of states instead of 8 by 8 leaves
+			if (level <= LEAF_LEVEL)
+				throw "Error: Only Two State Macrocell Files Are Supported";
+			if (level > 62)
+				throw "Error: Bad Macrocell Node";
+			uint32_t quadrants[4];
+			for (int i = 0; i < 4; i++)
+			{
+				if (child[i] >= ids.size() || (child[i] > 0 && levels[child[i]] != level - 1))
+					throw "Error: Bad Macrocell Node";
+				quadrants[i] = ids[child[i]];
+			}
+			ids.push_back(join(quadrants[0], quadrants[1], quadrants[2], quadrants[3], level));
+			levels.push_back(level);
+		}
+		p = (eol < end) ? eol + 1 : end;
+	}
+	if (first)
+		throw "Error: Not a Macrocell File";
+	if (ids.size() > 1)
+		setRoot(ids.back(), levels.back());
+}
+
+//returns the node equal to the given one, adding it if there is none
+uint32_t Macrocell::insert(const Node& node)
+{
+	uint64_t bucket = nodeHash(node.child, node.cells, node.level) & (buckets.size() - 1);
+	for (uint32_t i = buckets[bucket]; i != 0; i = nodes[i].next)
+	{
+		const Node& n = nodes[i];
+		if (n.level == node.level && n.cells == node.cells && n.child[0] == node.child[0] &&
+			n.child[1] == node.child[1] && n.child[2] == node.child[2] && n.child[3] == node.child[3])
+			return i;
+	}
+	uint32_t index = nodes.size();
+	nodes.push_back(node);
+	nodes[index].next = buckets[bucket];
+	buckets[bucket] = index;
+	//keeps the chains short, relinking every node into twice the buckets
+	if (nodes.size() > buckets.size())
+	{
+		buckets.assign(buckets.size() * 2, 0);
+		for (uint32_t i = nodes.size() - 1; i > 0; i--)
+		{
+			Node& n = nodes[i];
+			uint64_t b = nodeHash(n.child, n.cells, n.level) & (buckets.size() - 1);
+			n.next = buckets[b];
+			buckets[b] = i;
+		}
+	}
+	return index;
+}
+
+//returns the leaf with the given cells (bit 8 * row + column)
+uint32_t Macrocell::leaf(uint64_t cells)
+{
+	if (cells == 0)
+		return 0;
+	Node node = {{0, 0, 0, 0}, cells, 0, LEAF_LEVEL};
+	return insert(node);
+}
+
+//returns the node of the given level with the given quadrants
+uint32_t Macrocell::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se, int level)
+{
+	if ((nw | ne | sw | se) == 0)
+		return 0;
+	Node node = {{nw, ne, sw, se}, 0, 0, level};
+	return insert(node);
+}
+
+//makes a node of the given level the whole pattern
+void Macrocell::setRoot(uint32_t root, int level)
+{
+	this->root = root;
+	rootLevel = level;
+}
+
+//the 8 cells of a packed row from column c on, c can be a few columns left of the row
+static uint64_t rowBits(const uint64_t * row, long long words, long long c)
+{
+	if (c < 0)
+		return (rowBits(row, words, 0) << -c) & 0xff;
+	long long w = c >> 6;
+	int b = c & 63;
+	uint64_t bits = (w < words) ? row[w] >> b : 0;
+	if (b > 56 && w + 1 < words)
+		bits |= row[w + 1] << (64 - b);
+	return bits & 0xff;
+}
+
+/* makes the tree of a board packed as Board packs it, with cell (0, 0) at (-width / 2, -height / 2)
+The leaves that overlap the board are cut out of its rows, then each level is made by joining
+the one below in twos both ways, so a board costs a pass over its cells and a hash table
+lookup per block, and every block that repeats (most of them in a metacell pattern) is
+only stored once.*/
+void Macrocell::pack(const vector<uint64_t>& packed, int height, int width)
+{
+	const long long words = (width + 63) / 64;
+	int level = LEAF_LEVEL + 1;
+	while ((1LL << (level - 1)) < max(height - height / 2, width - width / 2))
+		level++;
+	if (height == 0 || width == 0)
+	{
+		setRoot(0, level);
+		return;
+	}
+	//the board's top left cell, from the root's top left corner
+	const long long half = 1LL << (level - 1);
+	const long long y0 = half - height / 2, x0 = half - width / 2;
+	//the blocks the board overlaps on the current level, rows [top, bottom) and columns [left, right)
+	long long top = y0 / 8, bottom = (y0 + height - 1) / 8 + 1;
+	long long left = x0 / 8, right = (x0 + width - 1) / 8 + 1;
+	vector<uint32_t> grid((bottom - top) * (right - left));
+	for (long long i = top; i < bottom; i++)
+	{
+		for (long long j = left; j < right; j++)
+		{
+			uint64_t cells = 0;
+			for (int k = 0; k < 8; k++)
+			{
+				long long r = i * 8 + k - y0;
+				if (r >= 0 && r < height)
+					cells |= rowBits(&packed[r * words], words, j * 8 - x0) << (8 * k);
+			}
+			grid[(i - top) * (right - left) + (j - left)] = leaf(cells);
+		}
+	}
+	for (int l = LEAF_LEVEL + 1; l <= level; l++)
+	{
+		long long nextTop = top / 2, nextBottom = (bottom - 1) / 2 + 1;
+		long long nextLeft = left / 2, nextRight = (right - 1) / 2 + 1;
+		vector<uint32_t> next((nextBottom - nextTop) * (nextRight - nextLeft));
+		for (long long i = nextTop; i < nextBottom; i++)
+		{
+			for (long long j = nextLeft; j < nextRight; j++)
+			{
+				uint32_t quadrants[4];
+				for (int q = 0; q < 4; q++)
+				{
+					long long y = 2 * i + (q >> 1), x = 2 * j + (q & 1);
+					bool inside = y >= top && y < bottom && x >= left && x < right;
+					quadrants[q] = inside ? grid[(y - top) * (right - left) + (x - left)] : 0;
+				}
+				next[(i - nextTop) * (nextRight - nextLeft) + (j - nextLeft)] =
+					join(quadrants[0], quadrants[1], quadrants[2], quadrants[3], l);
+			}
+		}
+		grid.swap(next);
+		top = nextTop;
+		bottom = nextBottom;
+		left = nextLeft;
+		right = nextRight;
+	}
+	setRoot(grid[0], level);
+}
+
+//ors the cells of a node with its top left corner at (x, y) into the window of height by width cells at (left, top)
+void Macrocell::unpack(uint32_t node, int level, long long y, long long x, long long top, long long left,
+	int height, int width, vector<uint64_t>& packed)
+{
+	const long long size = 1LL << level;
+	if (node == 0 || y >= top + height || x >= left + width || y + size <= top || x + size <= left)
+		return;
+	if (level > LEAF_LEVEL)
+	{
+		const long long half = size / 2;
+		for (int q = 0; q < 4; q++)
+			unpack(nodes[node].child[q], level - 1, y + (q >> 1) * half, x + (q & 1) * half, top, left, height, width, packed);
+		return;
+	}
+	const size_t words = (width + 63) / 64;
+	for (int k = 0; k < 8; k++)
+	{
+		long long r = y + k - top;
+		uint64_t bits = (nodes[node].cells >> (8 * k)) & 0xff;
+		if (r < 0 || r >= height || bits == 0)
+			continue;
+		long long c = x - left;
+		if (c < 0)
+		{
+			bits >>= -c;
+			c = 0;
+		}
+		//the bits past the width stay dead
+		if (c + 8 > width)
+			bits &= ((uint64_t)1 << (width - c)) - 1;
+		uint64_t * row = &packed[r * words];
+		int b = c & 63;
+		row[c >> 6] |= bits << b;
+		if (b > 56)
+			row[(c >> 6) + 1] |= bits >> (64 - b);
+	}
+}
+
+//packs the cells of the window of height by width cells with its top left corner at (left, top) as Board packs them
+vector<uint64_t> Macrocell::unpack(long long top, long long left, int height, int width)
+{
+	vector<uint64_t> packed(height * (size_t)((width + 63) / 64), 0);
+	const long long half = 1LL << (rootLevel - 1);
+	unpack(root, rootLevel, -half, -half, top, left, height, width, packed);
+	return packed;
+}
+
+/* finds the rows and columns of the live cells (bottom and right one past the last), false if there are none
+The bounds of every node are worked out once, children first, which is the order the nodes
+are in.*/
+bool Macrocell::bounds(long long& top, long long& left, long long& bottom, long long& right)
+{
+	if (root == 0)
+		return false;
+	const Bounds none = {LLONG_MAX, LLONG_MAX, LLONG_MIN, LLONG_MIN};
+	vector<Bounds> boxes(root + 1, none);
+	for (uint32_t i = 1; i <= root; i++)
+	{
+		const Node& n = nodes[i];
+		Bounds& box = boxes[i];
+		if (n.level == LEAF_LEVEL)
+		{
+			uint64_t columns = 0;
+			for (int k = 0; k < 8; k++)
+				columns |= (n.cells >> (8 * k)) & 0xff;
+			box.top = __builtin_ctzll(n.cells) / 8;
+			box.bottom = 8 - __builtin_clzll(n.cells) / 8;
+			box.left = __builtin_ctzll(columns);
+			box.right = 64 - __builtin_clzll(columns);
+			continue;
+		}
+		const long long half = 1LL << (n.level - 1);
+		for (int q = 0; q < 4; q++)
+		{
+			if (n.child[q] == 0)
+				continue;
+			const Bounds& child = boxes[n.child[q]];
+			long long dy = (q >> 1) * half, dx = (q & 1) * half;
+			box.top = min(box.top, child.top + dy);
+			box.left = min(box.left, child.left + dx);
+			box.bottom = max(box.bottom, child.bottom + dy);
+			box.right = max(box.right, child.right + dx);
+		}
+	}
+	const long long half = 1LL << (rootLevel - 1);
+	top = boxes[root].top - half;
+	left = boxes[root].left - half;
+	bottom = boxes[root].bottom - half;
+	right = boxes[root].right - half;
+	return true;
+}
+
+/* writes a macrocell file, leaving out the nodes the root does not use
+The nodes used are found from the root down (every node comes after its children, so one
+pass from the root back to the start does it) and renumbered, and the file is written at once.*/
+void Macrocell::save(string filename)
+{
+	vector<uint32_t> numbers(root + 1, 0);	//the number of every node in the file, 0 for the nodes left out
+	if (root != 0)
+		numbers[root] = 1;
+	for (uint32_t i = root; i > 0; i--)
+		if (numbers[i] != 0 && nodes[i].level > LEAF_LEVEL)
+			for (int q = 0; q < 4; q++)
+				if (nodes[i].child[q] != 0)
+					numbers[nodes[i].child[q]] = 1;
+
+	string out = "[M2] (GameOfGenes)\n";
+	if (!rule.empty())
+		out += "#R " + rule + "\n";
+	out += "#G " + to_string(generation) + "\n";
+	for (auto& comment : comments)
+		out += "#C " + comment + "\n";
+	uint32_t count = 0;
+	for (uint32_t i = 1; i <= root; i++)
+	{
+		if (numbers[i] == 0)
+			continue;
+		numbers[i] = ++count;
+		const Node& n = nodes[i];
+		if (n.level > LEAF_LEVEL)
+		{
+			out += to_string(n.level);
+			for (int q = 0; q < 4; q++)
+				out += " " + to_string(numbers[n.child[q]]);
+			out += '\n';
+			continue;
+		}
+		//the dead cells at the end of a row and the empty rows at the bottom are left out
+		int rows = 8 - __builtin_clzll(n.cells) / 8;
+		for (int r = 0; r < rows; r++)
+		{
+			uint64_t bits = (n.cells >> (8 * r)) & 0xff;
+			for (int c = 0; bits >> c; c++)
+				out += ((bits >> c) & 1) ? '*' : '.';
+			out += '$';
+		}
+		out += '\n';
+	}
+	//an empty pattern is a single empty node
+	if (root == 0)
+		out += to_string(rootLevel) + " 0 0 0 0\n";
+	ofstream file(filename, ios::binary);
+	file.write(out.data(), out.size());
+}
+
+//returns the whole pattern
+uint32_t Macrocell::getRoot()
+{
+	return root;
+}
+
+//returns the level of the root
+int Macrocell::getRootLevel()
+{
+	return rootLevel;
+}
+
+//returns the level of a node, 0 for the empty node
+int Macrocell::getLevel(uint32_t node)
+{
+	return nodes[node].level;
+}
+
+//returns a quadrant (0 nw, 1 ne, 2 sw, 3 se) of a node above the leaves
+uint32_t Macrocell::getChild(uint32_t node, int quadrant)
+{
+	return nodes[node].child[quadrant];
+}
+
+//returns the cells of a leaf
+uint64_t Macrocell::getCells(uint32_t node)
+{
+	return nodes[node].cells;
+}
+
+//returns the number of nodes, the empty one included
+size_t Macrocell::getNodeCount()
+{
+	return nodes.size();
+}
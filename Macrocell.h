@@ -0,0 +1,71 @@
+//Header file for macrocell files
+#ifndef MACROCELL_H_
+#define MACROCELL_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* the quadtree of a macrocell (.mc) file, the format Golly keeps huge patterns in. Every
+ * block of cells is a node and the nodes are hash-consed: a block that turns up again is
+ * the same node, so a pattern made of many copies of a few parts is stored (and written)
+ * once per distinct part. Leaves are 8 by 8 blocks (level 3), node 0 is the empty block of
+ * every level, and the other nodes are numbered in the order they were made, children
+ * before parents, which is the order a file lists them in.
+ * As in Golly the root is centred on the origin: a root of level L covers the cells from
+ * -2^(L-1) to 2^(L-1) - 1 both ways, x to the right and y down.
+ */
+class Macrocell
+{
+	struct Node
+	{
+		uint32_t child[4];		//the nw, ne, sw and se quadrants, 0 for an empty one (unused in leaves)
+		uint64_t cells;			//the cells of a leaf, bit 8 * row + column
+		uint32_t next;			//next node in the same hash bucket
+		int level;				//the block is 2^level cells wide
+	};
+
+	//the live cells of a node, relative to its top left corner
+	struct Bounds
+	{
+		long long top;
+		long long left;
+		long long bottom;		//one past the last row
+		long long right;		//one past the last column
+	};
+
+	std::vector<Node> nodes;		//node 0 is the empty block, then every node in the order it was made
+	std::vector<uint32_t> buckets;	//hash table of the nodes, heads of chains through Node::next
+	uint32_t root;					//the whole pattern
+	int rootLevel;					//the level of the root, kept apart since node 0 has none
+
+	uint32_t insert(const Node& node);	//returns the node equal to the given one, adding it if there is none
+	void unpack(uint32_t node, int level, long long y, long long x, long long top, long long left,
+		int height, int width, std::vector<uint64_t>& packed);	//ors the cells of a node with its top left corner at (x, y) into a window
+
+public:
+	static const int LEAF_LEVEL = 3;	//leaves are 2^3 cells wide
+
+	std::string rule;				//the rule, with Golly's topology suffix if it has one, "" for B3/S23
+	long long generation;			//the generation the pattern is at
+	std::vector<std::string> comments;	//the comment lines, without their "#C "
+
+	Macrocell();										//an empty pattern
+	Macrocell(std::string filename);					//reads a macrocell file
+	uint32_t leaf(uint64_t cells);						//returns the leaf with the given cells (bit 8 * row + column)
+	uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se, int level);	//returns the node of the given level with the given quadrants
+	void setRoot(uint32_t root, int level);				//makes a node of the given level the whole pattern
+	void pack(const std::vector<uint64_t>& packed, int height, int width);	//makes the tree of a board packed as Board packs it, with cell (0, 0) at (-width / 2, -height / 2) as Golly puts a bounded grid
+	std::vector<uint64_t> unpack(long long top, long long left, int height, int width);	//packs the cells of a window as Board packs them
+	bool bounds(long long& top, long long& left, long long& bottom, long long& right);	//the rows and columns of the live cells (bottom and right one past the last), false if there are none
+	void save(std::string filename);					//writes a macrocell file, leaving out the nodes the root does not use
+
+	uint32_t getRoot();									//returns the whole pattern
+	int getRootLevel();									//returns the level of the root
+	int getLevel(uint32_t node);						//returns the level of a node, 0 for the empty node
+	uint32_t getChild(uint32_t node, int quadrant);		//returns a quadrant (0 nw, 1 ne, 2 sw, 3 se) of a node above the leaves
+	uint64_t getCells(uint32_t node);					//returns the cells of a leaf
+	size_t getNodeCount();								//returns the number of nodes, the empty one included
+};
+
+#endif /* MACROCELL_H_ */
@@ -0,0 +1,680 @@
+#include "Objects.h"
+#include "Board.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+//scrambles the bits of a hash
+uint64_t mix(uint64_t h)
+{
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	return h ^ (h >> 31);
+}
+
+//hashes a rows by columns block of cells, cell(i, j) says whether the cell in row i and column j is alive
+template <typename CELL>
+static uint64_t hashCells(int rows, int columns, CELL cell)
+{
+	uint64_t hash = mix(((uint64_t)rows << 32) | (uint32_t)columns);
+	for (int i = 0; i < rows; i++)
+	{
+		uint64_t chunk = 0;
+		for (int j = 0; j < columns; j++)
+		{
+			chunk |= (uint64_t)cell(i, j) << (j & 63);
+			//every 64 cells (and at the end of the row) the chunk goes into the hash
+			if ((j & 63) == 63 || j == columns - 1)
+			{
+				hash = mix(hash ^ chunk);
+				chunk = 0;
+			}
+		}
+	}
+	return hash;
+}
+
+/* hashes a phase turned into one of its 8 orientations: 0 to 3 are quarter turns, 4 to 7
+ * mirror it left to right first. Where the phase lies does not change the hash.
+ */
+static uint64_t phaseHash(const Phase& phase, int orientation)
+{
+	int h = phase.height, w = phase.width;
+	int turns = orientation & 3;
+	bool mirror = orientation & 4;
+	int rows = (turns & 1) ? w : h, columns = (turns & 1) ? h : w;
+	auto cell = [&](int i, int j) -> bool
+	{
+		int k = mirror ? columns - 1 - j : j;
+		switch (turns)
+		{
+		case 1:
+			return phase.cells[k * w + (w - 1 - i)];
+		case 2:
+			return phase.cells[(h - 1 - i) * w + (w - 1 - k)];
+		case 3:
+			return phase.cells[(h - 1 - k) * w + i];
+		default:
+			return phase.cells[i * w + k];
+		}
+	};
+	return hashCells(rows, columns, cell);
+}
+
+//returns the hash of the object as it is now, the same wherever it lies (phaseHash() in orientation 0)
+uint64_t objectPhaseHash(const LifeObject& object)
+{
+	auto cell = [&](int i, int j) -> bool
+	{
+		return object.cells[i][j];
+	};
+	return hashCells(object.height, object.width, cell);
+}
+
+//the smallest hash of the 8 orientations of a phase
+static uint64_t orientedHash(const Phase& phase)
+{
+	uint64_t hash = phaseHash(phase, 0);
+	for (int orientation = 1; orientation < 8; orientation++)
+	{
+		uint64_t h = phaseHash(phase, orientation);
+		hash = (h < hash) ? h : hash;
+	}
+	return hash;
+}
+
+//reads the live cells of rows [top, bottom] and columns [left, right] of a board into a phase
+static void readPhase(Engine& board, int top, int bottom, int left, int right, Phase& phase)
+{
+	top = (top > 0) ? top : 0;
+	left = (left > 0) ? left : 0;
+	bottom = (bottom < board.getHeight() - 1) ? bottom : board.getHeight() - 1;
+	right = (right < board.getWidth() - 1) ? right : board.getWidth() - 1;
+	//first the bounding box of the live cells in the window
+	int firstRow = bottom + 1, lastRow = top - 1, firstColumn = right + 1, lastColumn = left - 1;
+	for (int r = top; r <= bottom; r++)
+	{
+		for (int c = left; c <= right; c++)
+		{
+			if (!board.getCell(r, c))
+				continue;
+			firstRow = (r < firstRow) ? r : firstRow;
+			lastRow = r;
+			firstColumn = (c < firstColumn) ? c : firstColumn;
+			lastColumn = (c > lastColumn) ? c : lastColumn;
+		}
+	}
+	phase.population = 0;
+	if (lastRow < firstRow)
+	{
+		phase.height = phase.width = 0;
+		return;
+	}
+	phase.top = firstRow;
+	phase.left = firstColumn;
+	phase.height = lastRow - firstRow + 1;
+	phase.width = lastColumn - firstColumn + 1;
+	phase.cells.assign(phase.height * phase.width, 0);
+	for (int r = 0; r < phase.height; r++)
+	{
+		for (int c = 0; c < phase.width; c++)
+		{
+			if (board.getCell(firstRow + r, firstColumn + c))
+			{
+				phase.cells[r * phase.width + c] = 1;
+				phase.population++;
+			}
+		}
+	}
+}
+
+/* returns the hash of a set of live cells (column, row), the same wherever they lie and whichever way they face
+Unlike orientedHash() it only looks at the live cells, so a sparse pattern millions of cells
+across is hashed in a moment: in each of the 8 orientations every cell is hashed by where it
+is in the bounding box and the hashes are added up, which does not depend on their order,
+and the smallest of the 8 sums is kept.*/
+uint64_t patternHash(const vector<pair<int, int>>& living)
+{
+	if (living.empty())
+		return mix(0);
+	long long top = living[0].second, left = living[0].first, bottom = top, right = left;
+	for (auto& cell : living)
+	{
+		top = (cell.second < top) ? cell.second : top;
+		bottom = (cell.second > bottom) ? cell.second : bottom;
+		left = (cell.first < left) ? cell.first : left;
+		right = (cell.first > right) ? cell.first : right;
+	}
+	const long long h = bottom - top + 1, w = right - left + 1;
+	uint64_t sums[8] = {0};
+	for (auto& cell : living)
+	{
+		const long long r = cell.second - top, c = cell.first - left;
+		//(row, column) in each orientation: 0 to 3 are quarter turns, 4 to 7 mirror left to right first
+		const long long rows[8] = {r, w - 1 - c, h - 1 - r, c, r, c, h - 1 - r, w - 1 - c};
+		const long long columns[8] = {c, r, w - 1 - c, h - 1 - r, w - 1 - c, r, c, h - 1 - r};
+		for (int o = 0; o < 8; o++)
+			sums[o] += mix(((uint64_t)rows[o] << 32) ^ (uint64_t)columns[o] ^ 0x9e3779b97f4a7c15ULL);
+	}
+	uint64_t hash = ~(uint64_t)0;
+	for (int o = 0; o < 8; o++)
+	{
+		//the height and width of the orientation go in too, turned ones are w by h
+		uint64_t size = (o & 1) ? (((uint64_t)w << 32) | (uint64_t)h) : (((uint64_t)h << 32) | (uint64_t)w);
+		uint64_t oriented = mix(sums[o] ^ mix(size));
+		hash = (oriented < hash) ? oriented : hash;
+	}
+	return hash;
+}
+
+//throws if the classifier cannot run the rule
+static void checkRule(const Rule& rule)
+{
+	if (rule.dyingStates > 0)
+		throw "The classifier cannot run Generations rules";
+	if (rule.birth & 1)
+		throw "The classifier cannot run rules with births on 0 neighbours";
+}
+
+/* gives objects[i] as many rows of cells as it is high
+If the list of rows of objects[i] cannot grow that far without allocating, it is traded for
+the list of another object that can, which takes its own rows along into the shorter list.
+Rows an object no longer needs are kept in spareRows for the next one that needs more,
+rather than freed, and taken from there before new ones are made. The rows are left as
+they were, the caller sizes and fills them.*/
+static void shapeRows(vector<LifeObject>& objects, int i, vector<vector<bool>>& spareRows)
+{
+	LifeObject& object = objects[i];
+	if ((int)object.cells.capacity() < object.height)
+	{
+		while (!object.cells.empty())
+		{
+			spareRows.push_back(move(object.cells.back()));
+			object.cells.pop_back();
+		}
+		for (size_t j = 0; j < objects.size(); j++)
+		{
+			vector<vector<bool>>& other = objects[j].cells;
+			if ((int)j == i || (int)other.capacity() < object.height || other.size() > object.cells.capacity())
+				continue;
+			object.cells.swap(other);
+			for (auto& row : object.cells)
+				other.push_back(move(row));
+			object.cells.clear();
+			break;
+		}
+		//one allocation rather than one every time push_back() runs out
+		if ((int)object.cells.capacity() < object.height)
+			object.cells.reserve(object.height);
+	}
+	while ((int)object.cells.size() > object.height)
+	{
+		spareRows.push_back(move(object.cells.back()));
+		object.cells.pop_back();
+	}
+	while ((int)object.cells.size() < object.height)
+	{
+		object.cells.push_back(vector<bool>());
+		if (spareRows.empty())
+			continue;
+		object.cells.back().swap(spareRows.back());
+		spareRows.pop_back();
+	}
+}
+
+ObjectFinder::ObjectFinder(): count(0)
+{
+}
+
+/* splits the live cells of a board into objects, returns how many there are
+Two live cells belong to the same object if they are at most twice the reach of the rule
+apart (2 cells for Life-like rules), since then there is a cell that has them both as
+neighbours. The board is looked at as a plane: an object that wraps around the edge of a
+torus comes out as two.*/
+int ObjectFinder::find(Engine& board)
+{
+	const int height = board.getHeight(), width = board.getWidth();
+	Rule rule = board.getRule();
+	const int link = 2 * ((rule.range > 0) ? rule.range : 1);
+	//-1 for dead cells, -2 for live cells no object has taken yet, otherwise the object the cell is in
+	owner.assign(height * (size_t)width, -1);
+	for (int r = 0; r < height; r++)
+		for (int c = 0; c < width; c++)
+			if (board.getCell(r, c))
+				owner[r * (size_t)width + c] = -2;
+
+	//the rows of the last board's objects all go back to the spares, so the objects of this one can take any of them
+	for (auto& object : objects)
+	{
+		while (!object.cells.empty())
+		{
+			spareRows.push_back(move(object.cells.back()));
+			object.cells.pop_back();
+		}
+	}
+	count = 0;
+	for (int r = 0; r < height; r++)
+	{
+		for (int c = 0; c < width; c++)
+		{
+			if (owner[r * (size_t)width + c] != -2)
+				continue;
+			//flood fill the object from its first cell
+			owner[r * (size_t)width + c] = count;
+			stack.assign(1, make_pair(r, c));
+			members.clear();
+			int top = r, bottom = r, left = c, right = c;
+			while (!stack.empty())
+			{
+				pair<int, int> cell = stack.back();
+				stack.pop_back();
+				members.push_back(cell);
+				top = (cell.first < top) ? cell.first : top;
+				bottom = (cell.first > bottom) ? cell.first : bottom;
+				left = (cell.second < left) ? cell.second : left;
+				right = (cell.second > right) ? cell.second : right;
+				for (int y = cell.first - link; y <= cell.first + link; y++)
+				{
+					for (int x = cell.second - link; x <= cell.second + link; x++)
+					{
+						if (y < 0 || y >= height || x < 0 || x >= width || owner[y * (size_t)width + x] != -2)
+							continue;
+						owner[y * (size_t)width + x] = count;
+						stack.push_back(make_pair(y, x));
+					}
+				}
+			}
+			//the objects of earlier boards are written over, so their cells keep their memory
+			if (count == (int)objects.size())
+				objects.push_back(LifeObject());
+			LifeObject& object = objects[count++];
+			object.top = top;
+			object.left = left;
+			object.height = bottom - top + 1;
+			object.width = right - left + 1;
+			shapeRows(objects, count - 1, spareRows);
+			for (auto& row : object.cells)
+				row.assign(object.width, false);
+			for (auto& cell : members)
+				object.cells[cell.first - top][cell.second - left] = true;
+			object.population = members.size();
+			object.kind = UNCLASSIFIED;
+			object.period = 0;
+			object.dx = 0;
+			object.dy = 0;
+			object.hash = 0;
+		}
+	}
+	return count;
+}
+
+//returns object i of the last board find() looked at
+LifeObject& ObjectFinder::object(int i)
+{
+	return objects[i];
+}
+
+//splits the live cells of a board into objects (see ObjectFinder::find())
+vector<LifeObject> findObjects(Engine& board)
+{
+	ObjectFinder finder;
+	int count = finder.find(board);
+	vector<LifeObject> objects;
+	for (int i = 0; i < count; i++)
+		objects.push_back(finder.object(i));
+	return objects;
+}
+
+ObjectClassifier::ObjectClassifier(): board(false, 1, 1), count(0)
+{
+	//the board is tiny, sharing its generations out over the cores would only cost time
+	board.setStepMode(SERIAL);
+}
+
+/* puts phase in the middle of an empty board with margin dead cells all round, so its top left cell is at (margin, margin)
+The cells are packed into packed and swapped with the board's own, which then become packed,
+so the two buffers take turns and neither is freed.*/
+void ObjectClassifier::place(const Rule& rule, int margin)
+{
+	const int height = phase.height + 2 * margin, width = phase.width + 2 * margin;
+	const size_t wordsPerRow = (width + 63) / 64;
+	packed.assign(height * wordsPerRow, 0);
+	for (int r = 0; r < phase.height; r++)
+	{
+		uint64_t * row = &packed[(margin + r) * wordsPerRow];
+		for (int c = 0; c < phase.width; c++)
+			if (phase.cells[r * phase.width + c])
+				row[(margin + c) >> 6] |= (uint64_t)1 << ((margin + c) & 63);
+	}
+	board.setRule(rule);
+	board.setPacked(height, width, packed);
+}
+
+/* runs the object on its own until it repeats itself, and writes the bounding box of every
+generation it ran into track (for the objects that repeat, only the generations of one
+period). See classify(object).*/
+void ObjectClassifier::run(LifeObject& object, const Rule& rule, int maxPeriod, vector<Box>& track)
+{
+	checkRule(rule);
+	const int reach = (rule.range > 0) ? rule.range : 1;
+	const int margin = reach + 8;
+
+	phase.top = object.top;
+	phase.left = object.left;
+	phase.height = object.height;
+	phase.width = object.width;
+	phase.cells.assign(object.height * object.width, 0);
+	for (int r = 0; r < object.height; r++)
+		for (int c = 0; c < object.width; c++)
+			phase.cells[r * object.width + c] = object.cells[r][c];
+	phase.population = object.population;
+
+	object.kind = UNCLASSIFIED;
+	object.period = 0;
+	object.dx = 0;
+	object.dy = 0;
+	track.clear();
+	if (object.population == 0)
+	{
+		object.hash = 0;
+		return;
+	}
+	object.hash = orientedHash(phase);
+	track.push_back({object.top, object.left, object.top + object.height - 1, object.left + object.width - 1});
+	const uint64_t start = phaseHash(phase, 0);
+	uint64_t canonical = object.hash;
+
+	//the board cell (0, 0) of the small board is at (originRow, originColumn) on the big one
+	place(rule, margin);
+	int originRow = object.top - margin, originColumn = object.left - margin;
+	int top = margin, left = margin;
+	for (int t = 1; t <= maxPeriod; t++)
+	{
+		//cells can be born up to reach past the bounding box, and they have to land on the board
+		if (top < reach || left < reach || top + phase.height + reach > board.getHeight() ||
+			left + phase.width + reach > board.getWidth())
+		{
+			originRow += top - margin;
+			originColumn += left - margin;
+			place(rule, margin);
+			top = left = margin;
+		}
+		board.runIteration();
+		readPhase(board, top - reach, top + phase.height - 1 + reach, left - reach, left + phase.width - 1 + reach, phase);
+		if (phase.population == 0)
+			return;
+		top = phase.top;
+		left = phase.left;
+		if (phaseHash(phase, 0) == start)
+		{
+			object.period = t;
+			object.dx = originColumn + left - object.left;
+			object.dy = originRow + top - object.top;
+			object.kind = (object.dx != 0 || object.dy != 0) ? SPACESHIP : (t == 1) ? STILL_LIFE : OSCILLATOR;
+			object.hash = canonical;
+			return;
+		}
+		uint64_t hash = orientedHash(phase);
+		canonical = (hash < canonical) ? hash : canonical;
+		track.push_back({originRow + top, originColumn + left, originRow + top + phase.height - 1, originColumn + left + phase.width - 1});
+	}
+}
+
+/* runs the object on its own until it repeats itself
+The object is put on a small board of its own with a margin around it, and every
+generation the bounding box of its cells is hashed. Once the hash is back to the one it
+started with, the generations that took are the period and the way the bounding box moved
+is the displacement. Spaceships would run off the small board, so whenever the cells get
+too close to an edge they are moved back to the middle of it. An object that dies, or does
+not repeat itself within maxPeriod generations, stays UNCLASSIFIED.
+Its hash is the smallest hash of every phase in every orientation, so copies of an object
+get the same hash wherever they are and whichever way they face.*/
+void ObjectClassifier::classify(LifeObject& object, const Rule& rule, int maxPeriod)
+{
+	run(object, rule, maxPeriod, track);
+}
+
+//runs the object on its own until it repeats itself (see ObjectClassifier::classify())
+void classifyObject(LifeObject& object, const Rule& rule, int maxPeriod)
+{
+	ObjectClassifier classifier;
+	classifier.classify(object, rule, maxPeriod);
+}
+
+//the bounding box of the object in generation g, false if it has died by then
+static bool boxAt(const LifeObject& object, const vector<Box>& track, int g, Box& box)
+{
+	if (object.period == 0)
+	{
+		if (g >= (int)track.size())
+			return false;
+		box = track[g];
+		return true;
+	}
+	//a periodic object is where it was a whole number of periods ago, moved on that many times
+	int laps = g / object.period;
+	box = track[g % object.period];
+	box.top += laps * object.dy;
+	box.bottom += laps * object.dy;
+	box.left += laps * object.dx;
+	box.right += laps * object.dx;
+	return true;
+}
+
+//the first generation (up to last) in which the two objects come close enough to affect each other, -1 if they never do
+static int firstContact(const LifeObject& a, const vector<Box>& trackA, const LifeObject& b, const vector<Box>& trackB,
+	int link, int last)
+{
+	Box boxA, boxB;
+	for (int g = 0; g <= last; g++)
+	{
+		if (!boxAt(a, trackA, g, boxA) || !boxAt(b, trackB, g, boxB))
+			return -1;
+		if (boxA.top - link <= boxB.bottom && boxB.top - link <= boxA.bottom &&
+			boxA.left - link <= boxB.right && boxB.left - link <= boxA.right)
+			return g;
+	}
+	return -1;
+}
+
+//puts the cells of a group of objects together into one, written over next[index]
+void ObjectClassifier::merge(const vector<int>& group, int index)
+{
+	LifeObject& merged = next[index];
+	const LifeObject& first = objects[group[0]];
+	merged.top = first.top;
+	merged.left = first.left;
+	int bottom = first.top + first.height - 1, right = first.left + first.width - 1;
+	for (int i : group)
+	{
+		const LifeObject& object = objects[i];
+		merged.top = (object.top < merged.top) ? object.top : merged.top;
+		merged.left = (object.left < merged.left) ? object.left : merged.left;
+		bottom = (object.top + object.height - 1 > bottom) ? object.top + object.height - 1 : bottom;
+		right = (object.left + object.width - 1 > right) ? object.left + object.width - 1 : right;
+	}
+	merged.height = bottom - merged.top + 1;
+	merged.width = right - merged.left + 1;
+	shapeRows(next, index, spareRows);
+	for (auto& row : merged.cells)
+		row.assign(merged.width, false);
+	merged.population = 0;
+	for (int i : group)
+	{
+		const LifeObject& object = objects[i];
+		for (int r = 0; r < object.height; r++)
+			for (int c = 0; c < object.width; c++)
+				if (object.cells[r][c])
+					merged.cells[object.top - merged.top + r][object.left - merged.left + c] = true;
+		merged.population += object.population;
+	}
+	merged.kind = UNCLASSIFIED;
+	merged.period = 0;
+	merged.dx = 0;
+	merged.dy = 0;
+	merged.hash = 0;
+}
+
+/* finds the objects of a board and classifies them all, returns how many there are
+Cells further apart than ObjectFinder looks can still meet later on (the parts of many
+big spaceships do), and then neither part repeats itself on its own. So every object
+that could not be classified is put together with the objects whose bounding box first
+comes close to its own while both are run on their own, and the result is classified
+again, until nothing more can be put together.
+In parallel every object runs on its own small board, with work stealing since a big or
+high period object takes much longer than a block. Otherwise they all run on this
+classifier's board one after the other, and nothing is allocated once the buffers are big
+enough: the objects and tracks of a round are swapped into place rather than copied.*/
+int ObjectClassifier::classify(Engine& board, int maxPeriod, bool parallel)
+{
+	Rule rule = board.getRule();
+	//checked here, an exception thrown inside a worker thread would end the program
+	checkRule(rule);
+	const int link = 2 * ((rule.range > 0) ? rule.range : 1);
+	count = finder.find(board);
+	if ((int)objects.size() < count)
+	{
+		objects.resize(count);
+		tracks.resize(count);
+	}
+	items.clear();
+	for (int i = 0; i < count; i++)
+	{
+		const LifeObject& found = finder.object(i);
+		LifeObject& object = objects[i];
+		object.top = found.top;
+		object.left = found.left;
+		object.height = found.height;
+		object.width = found.width;
+		shapeRows(objects, i, spareRows);
+		for (int r = 0; r < object.height; r++)
+			object.cells[r] = found.cells[r];
+		object.population = found.population;
+		items.push_back(i);
+	}
+	auto classifyItem = [&](int i)
+	{
+		//the threads cannot share the small board
+		ObjectClassifier classifier;
+		classifier.run(objects[i], rule, maxPeriod, tracks[i]);
+	};
+
+	while (!items.empty())
+	{
+		if (parallel)
+			ThreadPool::shared().runStealing(classifyItem, items.data(), items.size());
+		else
+			for (int i : items)
+				run(objects[i], rule, maxPeriod, tracks[i]);
+
+		//every unclassified object is joined to the objects it meets first (union find over the objects)
+		parent.resize(count);
+		for (int i = 0; i < count; i++)
+			parent[i] = i;
+		auto root = [&](int i)
+		{
+			while (parent[i] != i)
+				i = parent[i] = parent[parent[i]];
+			return i;
+		};
+		bool joined = false;
+		for (int a = 0; a < count; a++)
+		{
+			if (objects[a].kind != UNCLASSIFIED)
+				continue;
+			int first = maxPeriod;
+			partners.clear();
+			for (int b = 0; b < count; b++)
+			{
+				if (b == a)
+					continue;
+				int g = firstContact(objects[a], tracks[a], objects[b], tracks[b], link, first);
+				if (g < 0)
+					continue;
+				if (g < first)
+					partners.clear();
+				first = g;
+				partners.push_back(b);
+			}
+			for (int b : partners)
+			{
+				parent[root(b)] = root(a);
+				joined = true;
+			}
+		}
+		if (!joined)
+			break;
+
+		//the groups are merged into new objects, which are the only ones run again
+		groupFirst.assign(count, -1);
+		groupNext.resize(count);
+		for (int i = count - 1; i >= 0; i--)
+		{
+			groupNext[i] = groupFirst[root(i)];
+			groupFirst[root(i)] = i;
+		}
+		int nextCount = 0;
+		items.clear();
+		for (int r = 0; r < count; r++)
+		{
+			if (groupFirst[r] < 0)
+				continue;
+			if (nextCount == (int)next.size())
+			{
+				next.push_back(LifeObject());
+				nextTracks.push_back(vector<Box>());
+			}
+			if (groupNext[groupFirst[r]] < 0)
+			{
+				swap(next[nextCount], objects[groupFirst[r]]);
+				swap(nextTracks[nextCount], tracks[groupFirst[r]]);
+				nextCount++;
+				continue;
+			}
+			members.clear();
+			for (int i = groupFirst[r]; i >= 0; i = groupNext[i])
+				members.push_back(i);
+			items.push_back(nextCount);
+			merge(members, nextCount);
+			nextTracks[nextCount].clear();
+			nextCount++;
+		}
+		objects.swap(next);
+		tracks.swap(nextTracks);
+		count = nextCount;
+	}
+	return count;
+}
+
+//returns object i of the last board classify(board) looked at
+LifeObject& ObjectClassifier::object(int i)
+{
+	return objects[i];
+}
+
+//finds the objects of a board and classifies them all, in parallel (see ObjectClassifier::classify())
+vector<LifeObject> classifyObjects(Engine& board, int maxPeriod)
+{
+	ObjectClassifier classifier;
+	int count = classifier.classify(board, maxPeriod, true);
+	vector<LifeObject> objects;
+	for (int i = 0; i < count; i++)
+		objects.push_back(move(classifier.object(i)));
+	return objects;
+}
+
+//returns "still life", "oscillator"...
+string objectKindName(objectKind kind)
+{
+	switch (kind)
+	{
+	case STILL_LIFE:
+		return "still life";
+	case OSCILLATOR:
+		return "oscillator";
+	case SPACESHIP:
+		return "spaceship";
+	default:
+		return "unclassified";
+	}
+}
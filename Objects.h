@@ -0,0 +1,115 @@
+//Header file for the object classifier
+#ifndef OBJECTS_H_
+#define OBJECTS_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Board.h"
+
+enum objectKind {STILL_LIFE, OSCILLATOR, SPACESHIP, UNCLASSIFIED};	//what an object turned out to be
+
+/* one object found on a board: a group of live cells close enough to affect each other.
+ * Cells belong to the same object if some cell sees both of them, so an object can be
+ * stepped on its own and evolve exactly as it does on the board (as long as the other
+ * objects stay out of its way).
+ */
+struct LifeObject
+{
+	int top;								//top row of the bounding box on the board
+	int left;								//left column of the bounding box on the board
+	int height;								//height of the bounding box
+	int width;								//width of the bounding box
+	std::vector<std::vector<bool>> cells;	//the live cells inside the bounding box
+	int population;							//number of live cells
+	objectKind kind;						//what the object is, UNCLASSIFIED until classifyObject() has run
+	int period;								//generations until the object looks the same again, 0 if unclassified
+	int dx;									//columns the object moves right every period
+	int dy;									//rows the object moves down every period
+	uint64_t hash;							//the same for every phase, orientation and position of the object
+};
+
+//one phase of an object: its live cells cut down to their bounding box
+struct Phase
+{
+	int top;				//top row of the bounding box
+	int left;				//left column of the bounding box
+	int height;				//height of the bounding box
+	int width;				//width of the bounding box
+	std::vector<char> cells;	//the cells row by row, 1 for live ones
+	int population;			//number of live cells
+};
+
+//the bounding box of an object in one generation, on the board it came from
+struct Box
+{
+	int top;		//top row
+	int left;		//left column
+	int bottom;		//bottom row
+	int right;		//right column
+};
+
+/* splits boards into objects, keeping its buffers (and the memory of the objects it found)
+ * from one board to the next, so a caller that splits board after board (the census) stops
+ * allocating once they are big enough.
+ */
+class ObjectFinder
+{
+	std::vector<int> owner;							//the object each cell of the board is in
+	std::vector<std::pair<int, int>> stack;			//cells waiting to be looked at by the flood fill
+	std::vector<std::pair<int, int>> members;		//the cells of the object being filled
+	std::vector<LifeObject> objects;				//the objects found, only the first count are from the last board
+	std::vector<std::vector<bool>> spareRows;		//rows of cells taken off objects that got shorter, kept for the next ones
+	int count;										//number of objects on the last board
+
+public:
+	ObjectFinder();
+	int find(Engine& board);						//splits the live cells of a board into objects, returns how many there are
+	LifeObject& object(int i);						//returns object i of the last board find() looked at
+};
+
+/* classifies objects, keeping the small board they run on and every buffer from one object
+ * (and one board) to the next, so a caller that classifies object after object (the census)
+ * stops allocating once they are big enough, as ObjectFinder does for splitting boards.
+ */
+class ObjectClassifier
+{
+	Board board;									//the small board an object runs on
+	std::vector<uint64_t> packed;					//the cells put on board, swapped with its own so neither is freed
+	Phase phase;									//the phase of the object running
+	std::vector<Box> track;							//the bounding boxes of the object classify(object) is running
+	ObjectFinder finder;							//splits the boards classify(board) is given into objects
+	std::vector<LifeObject> objects;				//the objects of the last board, only the first count are from it
+	std::vector<std::vector<Box>> tracks;			//the bounding boxes of each object while it ran on its own
+	std::vector<LifeObject> next;					//the objects after putting the ones that meet together
+	std::vector<std::vector<Box>> nextTracks;		//the bounding boxes of the objects in next
+	std::vector<int> items;							//the objects still to run
+	std::vector<int> parent;						//union find over the objects, joining those that meet
+	std::vector<int> partners;						//the objects an unclassified one meets first
+	std::vector<int> groupFirst;					//the first object of every group, by the object at its root
+	std::vector<int> groupNext;						//the object after each one in its group, -1 for the last
+	std::vector<int> members;						//the objects of the group being put together
+	std::vector<std::vector<bool>> spareRows;		//rows of cells taken off objects that got shorter, kept for the next ones
+	int count;										//number of objects on the last board
+
+	void place(const Rule& rule, int margin);		//puts phase in the middle of an empty board with margin dead cells all round
+	void run(LifeObject& object, const Rule& rule, int maxPeriod, std::vector<Box>& track);	//runs the object on its own until it repeats itself, writing its bounding boxes into track
+	void merge(const std::vector<int>& group, int index);	//puts the cells of a group of objects together into one, written over next[index]
+
+public:
+	ObjectClassifier();
+	void classify(LifeObject& object, const Rule& rule, int maxPeriod = 256);	//runs the object on its own until it repeats itself
+	int classify(Engine& board, int maxPeriod = 256, bool parallel = false);	//finds the objects of a board and classifies them all, returns how many there are
+	LifeObject& object(int i);						//returns object i of the last board classify(board) looked at
+};
+
+uint64_t mix(uint64_t h);						//scrambles the bits of a hash
+std::vector<LifeObject> findObjects(Engine& board);		//splits the live cells of a board into objects
+uint64_t objectPhaseHash(const LifeObject& object);		//returns the hash of the object as it is now, the same wherever it lies
+uint64_t patternHash(const std::vector<std::pair<int, int>>& living);	//returns the hash of a set of live cells (column, row), the same wherever they lie and whichever way they face
+void classifyObject(LifeObject& object, const Rule& rule, int maxPeriod = 256);	//runs the object on its own until it repeats itself
+std::vector<LifeObject> classifyObjects(Engine& board, int maxPeriod = 256);	//finds the objects of a board and classifies them all
+std::string objectKindName(objectKind kind);				//returns "still life", "oscillator"...
+
+#endif /* OBJECTS_H_ */
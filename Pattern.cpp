@@ -10,13 +10,13 @@ Pattern::Pattern(std::string filename):Board(filename)
 void Pattern::rotate()
 {
 	//copies original pattern before making changes to location of new rotated pattern board
-	vector<vector<bool>> patternCopy(matrix[0].size(), vector<bool> (matrix.size(), 0));
+	vector<vector<bool>> patternCopy(width, vector<bool> (height, 0));
 	for(size_t i=0; i<patternCopy.size(); i++)
 	{
 		for (size_t j=0; j<patternCopy[0].size(); j++)
 		{
-		patternCopy[i][j] = matrix[matrix.size()-1-j][i];
+		patternCopy[i][j] = getCell(height-1-j, i);
 		}
 	}
-	matrix = patternCopy;
+	setMatrix(patternCopy);
 }
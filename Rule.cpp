@@ -0,0 +1,262 @@
+#include "Rule.h"
+#include <cstring>
+
+using namespace std;
+
+/* the letters Hensel notation gives the neighbour sets of 1 to 4 live neighbours, and one
+ * set of each letter (bit 0 nw, 1 n, 2 ne, 3 w, 4 e, 5 sw, 6 s, 7 se). A letter stands for
+ * every rotation and reflection of its set. 5 to 7 neighbours use the letters of 3 to 1,
+ * each naming the sets where the other neighbours are alive.
+ */
+static const char * const HENSEL_LETTERS[5] = {"", "ce", "ceaikn", "ceaiknjqry", "ceaiknjqrytwz"};
+static const int HENSEL_SETS[5][13] = {
+	{},
+	{4, 2},
+	{132, 18, 6, 66, 130, 36},
+	{164, 82, 22, 7, 50, 134, 14, 70, 38, 162},
+	{165, 90, 150, 198, 178, 135, 78, 54, 86, 166, 71, 147, 102}};
+
+//the position of each neighbour bit, in the order of the Rule neighbourhood numbering
+static const int NEIGHBOUR_DX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+static const int NEIGHBOUR_DY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+//the neighbour set turned by a quarter (turn 1 to 3 times) and mirrored left to right if mirror is set
+static int transform(int neighbours, int turns, bool mirror)
+{
+	int result = 0;
+	for (int bit = 0; bit < 8; bit++)
+	{
+		if (!((neighbours >> bit) & 1))
+			continue;
+		int dx = mirror ? -NEIGHBOUR_DX[bit] : NEIGHBOUR_DX[bit], dy = NEIGHBOUR_DY[bit];
+		for (int i = 0; i < turns; i++)
+		{
+			int x = dx;
+			dx = -dy;
+			dy = x;
+		}
+		result |= 1 << ((dy + 1) * 3 + dx + 1 - ((dy > 0 || (dy == 0 && dx > 0)) ? 1 : 0));
+	}
+	return result;
+}
+
+//adds the neighbour sets Hensel notation calls count + letter, false if there is no such letter
+bool henselNeighbours(int count, char letter, vector<int>& neighbours)
+{
+	if (count < 1 || count > 7)
+		return false;
+	int letters = (count <= 4) ? count : 8 - count;
+	const char * found = strchr(HENSEL_LETTERS[letters], letter);
+	if (!letter || !found)
+		return false;
+	int shape = HENSEL_SETS[letters][found - HENSEL_LETTERS[letters]];
+	if (count > 4)
+		shape ^= 255;
+	set<int> sets;
+	for (int turns = 0; turns < 4; turns++)
+	{
+		sets.insert(transform(shape, turns, false));
+		sets.insert(transform(shape, turns, true));
+	}
+	neighbours.insert(neighbours.end(), sets.begin(), sets.end());
+	return true;
+}
+
+//builds a rule from the sets in BoardData, a range above 0 makes a Larger than Life rule
+Rule makeRule(const set<int>& birthRule, const set<int>& survivalRule, int range, char neighbourhood, int states,
+	const vector<bool>& transitions)
+{
+	Rule rule = {0, 0, 0, neighbourhood, 1, 0, 1, 0, 0};
+	if (states > 2)
+		rule.dyingStates = ((states < MAX_STATES) ? states : MAX_STATES) - 2;
+	if (range > 0)
+	{
+		//Larger than Life counts are intervals, so only the ends of the sets matter
+		rule.range = range;
+		if (!birthRule.empty())
+		{
+			rule.birthMin = *birthRule.begin();
+			rule.birthMax = *birthRule.rbegin();
+		}
+		if (!survivalRule.empty())
+		{
+			rule.survivalMin = *survivalRule.begin();
+			rule.survivalMax = *survivalRule.rbegin();
+		}
+		return rule;
+	}
+	if (transitions.size() == 512)
+	{
+		//Hensel notation only names arrangements of the Moore neighbourhood
+		rule.neighbourhood = 'M';
+		//each count gets what most of its neighbourhoods do, the rest become exceptions
+		int alive[2][9] = {}, total[2][9] = {};
+		for (int i = 0; i < 512; i++)
+		{
+			int count = __builtin_popcount(i & 255);
+			total[i >> 8][count]++;
+			alive[i >> 8][count] += transitions[i];
+		}
+		for (int count = 0; count <= 8; count++)
+		{
+			if (2 * alive[0][count] > total[0][count])
+				rule.birth |= 1 << count;
+			if (2 * alive[1][count] > total[1][count])
+				rule.survival |= 1 << count;
+		}
+		for (int i = 0; i < 512; i++)
+		{
+			uint16_t mask = (i >> 8) ? rule.survival : rule.birth;
+			if ((bool)((mask >> __builtin_popcount(i & 255)) & 1) != transitions[i])
+				rule.exceptions[i >> 6] |= (uint64_t)1 << (i & 63);
+		}
+		return rule;
+	}
+	for (int count : birthRule)
+		if (count >= 0 && count <= 8)
+			rule.birth |= 1 << count;
+	for (int count : survivalRule)
+		if (count >= 0 && count <= 8)
+			rule.survival |= 1 << count;
+	return rule;
+}
+
+//the neighbour counts that give birth, as in BoardData
+set<int> birthSet(const Rule& rule)
+{
+	set<int> counts;
+	if (rule.range > 0)
+	{
+		for (int count = rule.birthMin; count <= rule.birthMax; count++)
+			counts.insert(count);
+		return counts;
+	}
+	for (int count = 0; count <= 8; count++)
+		if ((rule.birth >> count) & 1)
+			counts.insert(count);
+	return counts;
+}
+
+//the neighbour counts a live cell survives with, as in BoardData
+set<int> survivalSet(const Rule& rule)
+{
+	set<int> counts;
+	if (rule.range > 0)
+	{
+		for (int count = rule.survivalMin; count <= rule.survivalMax; count++)
+			counts.insert(count);
+		return counts;
+	}
+	for (int count = 0; count <= 8; count++)
+		if ((rule.survival >> count) & 1)
+			counts.insert(count);
+	return counts;
+}
+
+//whether each of the 512 neighbourhoods is alive next, for Life-like rules
+vector<bool> transitionTable(const Rule& rule)
+{
+	vector<bool> transitions(512);
+	for (int i = 0; i < 512; i++)
+	{
+		uint16_t mask = (i >> 8) ? rule.survival : rule.birth;
+		transitions[i] = (((mask >> __builtin_popcount(i & 255)) & 1) ^ (rule.exceptions[i >> 6] >> (i & 63))) & 1;
+	}
+	return transitions;
+}
+
+//writes the neighbour counts and Hensel letters that bring a cell with the given centre to life, eg "12" or "2-a"
+static string henselString(const vector<bool>& transitions, int centre)
+{
+	string text;
+	for (int count = 0; count <= 8; count++)
+	{
+		int letters = (count <= 4) ? count : 8 - count;
+		string with, without;
+		for (const char * letter = HENSEL_LETTERS[letters]; *letter; letter++)
+		{
+			vector<int> neighbours;
+			henselNeighbours(count, *letter, neighbours);
+			//the letters split the neighbourhoods, so checking one of each letter is enough
+			if (transitions[(centre << 8) | neighbours[0]])
+				with += *letter;
+			else
+				without += *letter;
+		}
+		if (letters == 0)
+		{
+			if (transitions[(centre << 8) | ((count == 8) ? 255 : 0)])
+				text += '0' + count;
+		}
+		else if (without.empty())
+			text += '0' + count;
+		else if (!with.empty())
+			text += (char)('0' + count) + ((with.size() <= without.size()) ? with : "-" + without);
+	}
+	return text;
+}
+
+//the number of cells in the neighbourhood, not counting the centre
+int neighbourCount(const Rule& rule)
+{
+	int range = (rule.range > 0) ? rule.range : 1;
+	if (rule.neighbourhood == 'N')
+		return 2 * range * (range + 1);
+	if (rule.neighbourhood == 'H')
+		return 6;
+	return (2 * range + 1) * (2 * range + 1) - 1;
+}
+
+//true if the cell dy rows down and dx columns right is a neighbour (Life-like rules)
+bool inNeighbourhood(const Rule& rule, int dy, int dx)
+{
+	if (dy == 0 && dx == 0)
+		return false;
+	if (rule.neighbourhood == 'N')
+		return dy == 0 || dx == 0;
+	if (rule.neighbourhood == 'H')
+		return dy != -dx;
+	return true;
+}
+
+//the number of cell states, 2 unless it is a Generations rule
+int stateCount(const Rule& rule)
+{
+	return rule.dyingStates + 2;
+}
+
+//writes the rule in B/S notation, eg "B3/S23" or "B2/S/C3", or as "R5,C0,M0,S33..57,B34..45,NM"
+string ruleString(const Rule& rule)
+{
+	if (rule.range > 0)
+	{
+		//the centre is never counted, hence M0
+		return "R" + to_string(rule.range) + ",C" + to_string(rule.dyingStates ? stateCount(rule) : 0) + ",M0,S" + to_string(rule.survivalMin) + ".." +
+			to_string(rule.survivalMax) + ",B" + to_string(rule.birthMin) + ".." +
+			to_string(rule.birthMax) + ",N" + rule.neighbourhood;
+	}
+	string text = "B";
+	if (nonTotalistic(rule))
+	{
+		vector<bool> transitions = transitionTable(rule);
+		text += henselString(transitions, 0) + "/S" + henselString(transitions, 1);
+		if (rule.dyingStates > 0)
+			text += "/C" + to_string(stateCount(rule));
+		return text;
+	}
+	for (int count = 0; count <= 8; count++)
+		if ((rule.birth >> count) & 1)
+			text += '0' + count;
+	text += "/S";
+	for (int count = 0; count <= 8; count++)
+		if ((rule.survival >> count) & 1)
+			text += '0' + count;
+	if (rule.dyingStates > 0)
+		text += "/C" + to_string(stateCount(rule));
+	//the neighbourhood goes at the very end, as in Golly
+	if (rule.neighbourhood == 'N')
+		text += 'V';
+	else if (rule.neighbourhood == 'H')
+		text += 'H';
+	return text;
+}
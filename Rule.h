@@ -0,0 +1,105 @@
+//Header file for the Life-like rules
+#ifndef RULE_H_
+#define RULE_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+/* a Life-like rule as two masks over the number of live neighbours (0 to 8):
+ * bit n of birth is set if a dead cell with n neighbours comes alive,
+ * bit n of survival is set if a live cell with n neighbours stays alive.
+ * The neighbours are the 8 cells around it (Moore), the 4 next to it (von Neumann), or
+ * the 6 of a hexagonal grid drawn skewed on the square one, which are every cell around
+ * it but the ne and sw ones (as in Golly).
+ * A range above 0 makes it a Larger than Life rule instead: the neighbours are every
+ * cell within range steps (Moore) or range steps along the axes (von Neumann), the
+ * centre cell not included, and the counts that give birth and survival are the
+ * intervals [birthMin, birthMax] and [survivalMin, survivalMax] (empty if min > max).
+ * Either kind can be a Generations rule: a live cell that does not survive goes through
+ * dyingStates more states (2, 3...) before it is dead, a dying cell is not counted as a
+ * neighbour and nothing is born in it.
+ * A Life-like rule can also be isotropic non-totalistic (Hensel notation, eg "B2-a/S12"),
+ * where which neighbours are alive matters and not just how many. Its neighbourhoods are
+ * numbered with bit 0 nw, 1 n, 2 ne, 3 w, 4 e, 5 sw, 6 s, 7 se and bit 8 the centre. The
+ * masks then hold what most neighbourhoods with each count do, and bit i of exceptions
+ * is set if neighbourhood i does the opposite, so a totalistic rule has no exceptions.
+ */
+struct Rule
+{
+	uint16_t birth;			//neighbour counts that give birth
+	uint16_t survival;		//neighbour counts a live cell survives with
+	uint8_t range;			//0 for Life-like rules, otherwise the Larger than Life radius (1 to MAX_RANGE)
+	char neighbourhood;		//'M' for Moore, 'N' for von Neumann, 'H' for hexagonal (Life-like rules only)
+	uint16_t birthMin;		//fewest neighbours that give birth (Larger than Life only)
+	uint16_t birthMax;		//most neighbours that give birth (Larger than Life only)
+	uint16_t survivalMin;	//fewest neighbours a live cell survives with (Larger than Life only)
+	uint16_t survivalMax;	//most neighbours a live cell survives with (Larger than Life only)
+	uint8_t dyingStates;	//number of states a cell decays through once it dies, 0 for two state rules
+	uint64_t exceptions[8];	//the neighbourhoods that go against the masks (non-totalistic rules only)
+};
+
+const int MAX_RANGE = 10;	//the largest Larger than Life radius the engines run
+const int MAX_STATES = 64;	//the most states a Generations rule can have (.brd files write a state as '0' + state)
+
+//true if the rule looks at which neighbours are alive and not just at how many
+inline bool nonTotalistic(const Rule& rule)
+{
+	uint64_t any = 0;
+	for (int i = 0; i < 8; i++)
+		any |= rule.exceptions[i];
+	return any != 0;
+}
+
+//true if both rules give birth and survival on the same neighbourhoods, whatever their number of states
+inline bool sameCounts(const Rule& a, const Rule& b)
+{
+	if (a.range != b.range)
+		return false;
+	if (a.range == 0)
+	{
+		if (a.neighbourhood != b.neighbourhood)
+			return false;
+		for (int i = 0; i < 8; i++)
+			if (a.exceptions[i] != b.exceptions[i])
+				return false;
+		return a.birth == b.birth && a.survival == b.survival;
+	}
+	return a.neighbourhood == b.neighbourhood && a.birthMin == b.birthMin && a.birthMax == b.birthMax &&
+		a.survivalMin == b.survivalMin && a.survivalMax == b.survivalMax;
+}
+
+inline bool operator==(const Rule& a, const Rule& b)
+{
+	return sameCounts(a, b) && a.dyingStates == b.dyingStates;
+}
+
+inline bool operator!=(const Rule& a, const Rule& b)
+{
+	return !(a == b);
+}
+
+//the rules with their own compiled kernels
+constexpr Rule CONWAY = {1 << 3, (1 << 2) | (1 << 3), 0, 'M'};								//B3/S23
+constexpr Rule HIGHLIFE = {(1 << 3) | (1 << 6), (1 << 2) | (1 << 3), 0, 'M'};				//B36/S23
+constexpr Rule DAY_AND_NIGHT = {(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8),
+	(1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8), 0, 'M'};						//B3678/S34678
+constexpr Rule SEEDS = {1 << 2, 0, 0, 'M'};													//B2/S
+
+/* builds a rule from the sets in BoardData, a range above 0 makes a Larger than Life rule and more than 2 states a
+ * Generations rule. A 512 entry transitions table (whether each neighbourhood is alive next) makes a non-totalistic
+ * rule and overrides the sets.
+ */
+Rule makeRule(const std::set<int>& birthRule, const std::set<int>& survivalRule, int range = 0, char neighbourhood = 'M',
+	int states = 2, const std::vector<bool>& transitions = std::vector<bool>());
+std::vector<bool> transitionTable(const Rule& rule);	//whether each of the 512 neighbourhoods is alive next, for Life-like rules
+bool henselNeighbours(int count, char letter, std::vector<int>& neighbours);	//adds the neighbour sets Hensel notation calls count + letter, false if there is no such letter
+std::set<int> birthSet(const Rule& rule);			//the neighbour counts that give birth, as in BoardData
+std::set<int> survivalSet(const Rule& rule);		//the neighbour counts a live cell survives with, as in BoardData
+int neighbourCount(const Rule& rule);				//the number of cells in the neighbourhood, not counting the centre
+bool inNeighbourhood(const Rule& rule, int dy, int dx);	//true if the cell dy rows down and dx columns right is a neighbour (Life-like rules)
+int stateCount(const Rule& rule);					//the number of cell states, 2 unless it is a Generations rule
+std::string ruleString(const Rule& rule);			//writes the rule in B/S notation, eg "B3/S23", "B2-a/S12", "B2/S34H" or "B2/S/C3", or as "R5,C0,M0,S33..57,B34..45,NM"
+
+#endif /* RULE_H_ */
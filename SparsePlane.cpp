@@ -0,0 +1,303 @@
+#include "SparsePlane.h"
+#include "Kernels.h"
+#include "ThreadPool.h"
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+//the offsets of the 8 neighbouring tiles, in the order of Tile::neighbours
+static const int NEIGHBOUR_X[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+static const int NEIGHBOUR_Y[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+//an empty plane, looked at through a height by width window
+SparsePlane::SparsePlane(int height, int width)
+{
+	this->height = height;
+	this->width = width;
+	this->iterations = 0;
+	this->births = 0;
+	this->deaths = 0;
+	this->population = 0;
+	setRule(CONWAY);
+}
+
+//loads a plane from any format loadFormat() reads
+SparsePlane::SparsePlane(string filename)
+{
+	BoardData data = loadFormat(filename);
+	height = data.height;
+	width = data.width;
+	iterations = data.iterations;
+	births = data.births;
+	deaths = data.deaths;
+	population = 0;
+	setRule(makeRule(data.birthRule, data.survivalRule, data.range, data.neighbourhood, data.states, data.transitions));
+	for (auto& cell : liveCells(data))
+		toggle(cell.second, cell.first, true);
+}
+
+//packs tile coordinates into a map key
+uint64_t SparsePlane::key(int tx, int ty)
+{
+	return ((uint64_t)(uint32_t)tx << 32) | (uint32_t)ty;
+}
+
+//returns the tile, creating it if needed
+SparsePlane::Tile& SparsePlane::tileAt(int tx, int ty)
+{
+	//operator[] value-initializes a new tile, so it starts out dead
+	return tiles[key(tx, ty)];
+}
+
+//returns the tile, nullptr if there is none
+SparsePlane::Tile * SparsePlane::findTile(int tx, int ty)
+{
+	auto it = tiles.find(key(tx, ty));
+	return (it == tiles.end()) ? nullptr : &it->second;
+}
+
+/* creates the tiles next to live edge cells, where births can happen, and deletes the
+ * empty tiles that nothing can be born in. A tile that empties is only deleted here, at
+ * the start of the next generation, so a tile that would be created again straight
+ * away (next to a still life on a tile edge, say) is kept instead of reallocated.
+ */
+void SparsePlane::updateTiles()
+{
+	borderTiles.clear();
+	for (auto& entry : tiles)
+	{
+		Tile& tile = entry.second;
+		int tx = (int)(entry.first >> 32);
+		int ty = (int)(uint32_t)entry.first;
+		uint64_t columns = 0;
+		for (int y = 0; y < TILE_SIZE; y++)
+			columns |= tile.cells[y];
+		tile.needed = columns != 0;
+		uint64_t top = tile.cells[0];
+		uint64_t bottom = tile.cells[TILE_SIZE - 1];
+		bool west = columns & 1, east = columns >> 63;
+		bool want[8] = {(bool)(top & 1), top != 0, (bool)(top >> 63), west, east,
+			(bool)(bottom & 1), bottom != 0, (bool)(bottom >> 63)};
+		for (int i = 0; i < 8; i++)
+		{
+			if (want[i])
+				borderTiles.push_back(make_pair(tx + NEIGHBOUR_X[i], ty + NEIGHBOUR_Y[i]));
+		}
+	}
+	//new tiles are only added after the loop, adding them during it could rehash the map under the iterator
+	for (auto& tile : borderTiles)
+		tileAt(tile.first, tile.second).needed = true;
+	for (auto it = tiles.begin(); it != tiles.end();)
+	{
+		if (it->second.needed)
+			++it;
+		else
+			it = tiles.erase(it);
+	}
+}
+
+//computes the next generation of a tile into nextCells
+template <typename RULE>
+void SparsePlane::stepTile(Tile& tile, const RULE& rule)
+{
+	//the tile's rows with one row of halo above and below, plus the same rows of the tiles to either side
+	uint64_t mid[TILE_SIZE + 2], west[TILE_SIZE + 2], east[TILE_SIZE + 2];
+	Tile ** n = tile.neighbours;
+	mid[0] = n[1] ? n[1]->cells[TILE_SIZE - 1] : 0;
+	west[0] = n[0] ? n[0]->cells[TILE_SIZE - 1] : 0;
+	east[0] = n[2] ? n[2]->cells[TILE_SIZE - 1] : 0;
+	for (int y = 0; y < TILE_SIZE; y++)
+	{
+		mid[y + 1] = tile.cells[y];
+		west[y + 1] = n[3] ? n[3]->cells[y] : 0;
+		east[y + 1] = n[4] ? n[4]->cells[y] : 0;
+	}
+	mid[TILE_SIZE + 1] = n[6] ? n[6]->cells[0] : 0;
+	west[TILE_SIZE + 1] = n[5] ? n[5]->cells[0] : 0;
+	east[TILE_SIZE + 1] = n[7] ? n[7]->cells[0] : 0;
+
+	int born = 0, died = 0;
+	for (int y = 0; y < TILE_SIZE; y++)
+	{
+		const uint64_t * m = mid + y;
+		const uint64_t * w = west + y;
+		const uint64_t * e = east + y;
+		uint64_t next = rule.template word<uint64_t>(
+			(m[0] << 1) | (w[0] >> 63), m[0], (m[0] >> 1) | (e[0] << 63),
+			(m[1] << 1) | (w[1] >> 63), m[1], (m[1] >> 1) | (e[1] << 63),
+			(m[2] << 1) | (w[2] >> 63), m[2], (m[2] >> 1) | (e[2] << 63));
+		born += __builtin_popcountll(next & ~m[1]);
+		died += __builtin_popcountll(m[1] & ~next);
+		tile.nextCells[y] = next;
+	}
+	tile.births = born;
+	tile.deaths = died;
+}
+
+//computes the next generation of every tile in tileList
+template <typename RULE>
+void SparsePlane::stepTiles(const RULE& rule)
+{
+	//every tile only writes its own nextCells, so they can all be computed at once
+	auto step = [&](int i)
+	{
+		stepTile(*tileList[i], rule);
+	};
+	ThreadPool::shared().runStealing(step, tileOrder.data(), tileOrder.size());
+}
+
+//toggles the cell from true to false or false to true
+void SparsePlane::toggle(int r, int c)
+{
+	toggle(r, c, !getCell(r, c));
+}
+
+//sets the cell to living
+void SparsePlane::toggle(int r, int c, bool living)
+{
+	if (getCell(r, c) == living)
+		return;
+	Tile& tile = tileAt(c >> 6, r >> 6);
+	tile.cells[r & 63] ^= (uint64_t)1 << (c & 63);
+	population += living ? 1 : -1;
+}
+
+//runs one iteration
+void SparsePlane::runIteration()
+{
+	updateTiles();
+
+	tileList.clear();
+	tileKeys.clear();
+	for (auto& entry : tiles)
+	{
+		tileList.push_back(&entry.second);
+		tileKeys.push_back(entry.first);
+	}
+	for (size_t i = 0; i < tileList.size(); i++)
+	{
+		int tx = (int)(tileKeys[i] >> 32);
+		int ty = (int)(uint32_t)tileKeys[i];
+		for (int j = 0; j < 8; j++)
+			tileList[i]->neighbours[j] = findTile(tx + NEIGHBOUR_X[j], ty + NEIGHBOUR_Y[j]);
+	}
+	tileOrder.resize(tileList.size());
+	for (size_t i = 0; i < tileOrder.size(); i++)
+		tileOrder[i] = i;
+
+	if (rule == CONWAY)
+		stepTiles(FixedRule<CONWAY.birth, CONWAY.survival>());
+	else if (rule.neighbourhood == 'N')
+		stepTiles(ShapedRule<VonNeumannNeighbourhood, MaskRule>(rule));
+	else if (rule.neighbourhood == 'H')
+		stepTiles(ShapedRule<HexagonalNeighbourhood, MaskRule>(rule));
+	else if (nonTotalistic(rule))
+		stepTiles(HenselRule(rule));
+	else
+		stepTiles(MaskRule(rule));
+
+	for (size_t i = 0; i < tileList.size(); i++)
+	{
+		Tile& tile = *tileList[i];
+		memcpy(tile.cells, tile.nextCells, sizeof(tile.cells));
+		births += tile.births;
+		deaths += tile.deaths;
+		population += tile.births - tile.deaths;
+	}
+	iterations++;
+}
+
+//runs the given number of iterations
+void SparsePlane::runIteration(long long runs)
+{
+	for (long long i = 0; i < runs; i++)
+		runIteration();
+}
+
+//save the viewed area as a .brd file
+void SparsePlane::saveState(string fileName)
+{
+	ofstream out(fileName);
+	out << height << endl;
+	out << width << endl;
+	out << false << endl;	//the plane does not wrap around
+	out << iterations << endl;
+	out << births << endl;
+	out << deaths << endl;
+	out << ruleString(rule) << endl;
+	string line(width, '0');
+	for (int i = 0; i < height; i++)
+	{
+		for (int j = 0; j < width; j++)
+			line[j] = getCell(i, j) ? '1' : '0';
+		out << line << endl;
+	}
+}
+
+//changes the birth and survival rule (B0, Larger than Life and Generations rules are not supported)
+void SparsePlane::setRule(const Rule& rule)
+{
+	if (rule.range > 0)
+		throw "The sparse plane cannot run Larger than Life rules";
+	if (rule.dyingStates > 0)
+		throw "The sparse plane cannot run Generations rules";
+	if (rule.birth & 1)
+		throw "The sparse plane cannot run rules with births on 0 neighbours";
+	this->rule = rule;
+}
+
+//returns the birth and survival rule
+Rule SparsePlane::getRule()
+{
+	return rule;
+}
+
+//returns true if the cell is alive
+bool SparsePlane::getCell(int r, int c)
+{
+	Tile * tile = findTile(c >> 6, r >> 6);
+	return tile && ((tile->cells[r & 63] >> (c & 63)) & 1);
+}
+
+//returns the height of the area the board looks at
+int SparsePlane::getHeight()
+{
+	return height;
+}
+
+//returns the width of the area the board looks at
+int SparsePlane::getWidth()
+{
+	return width;
+}
+
+//returns the number of iterations that were run
+long long SparsePlane::getIterations()
+{
+	return iterations;
+}
+
+//returns the number of births that occurred
+long long SparsePlane::getBirths()
+{
+	return births;
+}
+
+//returns the number of deaths that occurred
+long long SparsePlane::getDeaths()
+{
+	return deaths;
+}
+
+//returns the number of live cells
+long long SparsePlane::getPopulation()
+{
+	return population;
+}
+
+//returns the number of tiles allocated
+int SparsePlane::getTileCount()
+{
+	return tiles.size();
+}
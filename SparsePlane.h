@@ -0,0 +1,80 @@
+//Header file for the sparse plane engine
+#ifndef SPARSEPLANE_H_
+#define SPARSEPLANE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Engine.h"
+#include "Formats.h"
+#include "Util.h"
+
+/* an engine for an unbounded plane, so spaceships and gun streams fly off forever
+ * instead of wrapping around or dying at the edge. The plane is cut into 64x64 tiles
+ * (one 64-bit word per tile row) kept in a hash map keyed by tile coordinates. Only
+ * tiles with live cells exist: a tile is created once cells are about to be born in
+ * it and deleted once it empties, so memory follows the live area rather than the
+ * bounding box. The height and width only describe the area getCell() and saveState()
+ * look at, and wrapAround is ignored. Rules where cells are born with 0 neighbours
+ * would fill the whole plane, so they are rejected, and so
+ * are Larger than Life and Generations rules.
+ */
+class SparsePlane : public Engine
+{
+	static const int TILE_SIZE = 64;		//a tile is TILE_SIZE rows of one 64-bit word each
+
+	struct Tile
+	{
+		uint64_t cells[TILE_SIZE];			//the rows of the tile, bit c is column c
+		uint64_t nextCells[TILE_SIZE];		//the next generation is written here, then copied back
+		Tile * neighbours[8];				//nw, n, ne, w, e, sw, s, se, nullptr where there is no tile
+		int births;							//births in the tile during the last generation
+		int deaths;							//deaths in the tile during the last generation
+		bool needed;						//set by updateTiles() if the tile has live cells or births can happen in it
+	};
+
+	std::unordered_map<uint64_t, Tile> tiles;	//every tile with live cells, keyed by key(tx, ty)
+	std::vector<Tile*> tileList;				//the tiles being stepped this generation
+	std::vector<uint64_t> tileKeys;				//the keys of the tiles in tileList
+	std::vector<int> tileOrder;					//0 .. tileList.size() - 1, handed to the thread pool
+	std::vector<std::pair<int, int>> borderTiles;	//coordinates of the tiles updateTiles() has to keep
+	int height;									//height of the area the board looks at
+	int width;									//width of the area the board looks at
+	long long iterations;						//number of iterations that have been run
+	long long births;							//number of births so far
+	long long deaths;							//number of deaths so far
+	long long population;						//number of live cells
+	Rule rule;									//the birth and survival rule
+
+	static uint64_t key(int tx, int ty);		//packs tile coordinates into a map key
+	Tile& tileAt(int tx, int ty);				//returns the tile, creating it if needed
+	Tile * findTile(int tx, int ty);			//returns the tile, nullptr if there is none
+	void updateTiles();							//creates the tiles births can happen in and deletes the ones that stay empty
+	template <typename RULE>
+	void stepTile(Tile& tile, const RULE& rule);	//computes the next generation of a tile into nextCells
+	template <typename RULE>
+	void stepTiles(const RULE& rule);			//computes the next generation of every tile in tileList
+
+public:
+	SparsePlane(int height, int width);			//an empty plane, looked at through a height by width window
+	SparsePlane(std::string filename);			//loads a plane from any format loadFormat() reads
+	void toggle(int r, int c);					//toggles the cell from true to false or false to true
+	void toggle(int r, int c, bool living);		//sets the cell to living
+	void runIteration();						//runs one iteration
+	void runIteration(long long runs);			//runs the given number of iterations
+	void saveState(std::string fileName);		//save the viewed area as a .brd file
+	void setRule(const Rule& rule);				//changes the birth and survival rule (B0, Larger than Life and Generations rules are not supported)
+	Rule getRule();								//returns the birth and survival rule
+
+	bool getCell(int r, int c);					//returns true if the cell is alive
+	int getHeight();							//returns the height of the area the board looks at
+	int getWidth();								//returns the width of the area the board looks at
+	long long getIterations();					//returns the number of iterations that were run
+	long long getBirths();						//returns the number of births that occurred
+	long long getDeaths();						//returns the number of deaths that occurred
+	long long getPopulation();					//returns the number of live cells
+	int getTileCount();							//returns the number of tiles allocated
+};
+
+#endif /* SPARSEPLANE_H_ */
@@ -0,0 +1,145 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+//set while a thread is running a task, so tasks that post their own batches run them inline
+static thread_local bool insideTask = false;
+
+StealQueue::StealQueue(): items(nullptr), head(0), tail(0)
+{
+}
+
+//fills the queue with items [begin, end)
+void StealQueue::reset(const int * items, int begin, int end)
+{
+	lock_guard<mutex> guard(lock);
+	this->items = items;
+	head = begin;
+	tail = end;
+}
+
+//takes an item from the back, false if the queue is empty
+bool StealQueue::pop(int& item)
+{
+	lock_guard<mutex> guard(lock);
+	if (head >= tail)
+		return false;
+	item = items[--tail];
+	return true;
+}
+
+//takes an item from the front, false if the queue is empty
+bool StealQueue::steal(int& item)
+{
+	lock_guard<mutex> guard(lock);
+	if (head >= tail)
+		return false;
+	item = items[head++];
+	return true;
+}
+
+//creates a pool with the given number of threads, 0 uses one per core
+ThreadPool::ThreadPool(int threads): task(nullptr), context(nullptr), count(0), next(0), busy(0), batch(0), stopping(false)
+{
+	if (threads <= 0)
+		threads = thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	queues.reset(new StealQueue[threads]);
+	//the thread calling run() works too, so it only needs threads - 1 helpers
+	for (int i = 1; i < threads; i++)
+		workers.push_back(thread(&ThreadPool::workerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+//processes task indices until there are none left
+void ThreadPool::runTasks()
+{
+	int index;
+	insideTask = true;
+	while ((index = next.fetch_add(1)) < count)
+		task(context, index);
+	insideTask = false;
+}
+
+//the loop each worker thread runs
+void ThreadPool::workerLoop()
+{
+	unsigned long long seen = 0;
+	while (true)
+	{
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&]{ return stopping || batch != seen; });
+			if (stopping)
+				return;
+			seen = batch;
+		}
+		runTasks();
+		{
+			unique_lock<mutex> guard(lock);
+			busy--;
+		}
+		done.notify_one();
+	}
+}
+
+//true if posting a batch would be pointless (or deadlock)
+bool ThreadPool::mustRunInline()
+{
+	//there is no one to share with, or we are already inside one of the pool's tasks
+	return workers.empty() || insideTask;
+}
+
+void ThreadPool::run(void (*task)(void*, int), void * context, int count)
+{
+	if (count <= 1 || mustRunInline())
+	{
+		for (int i = 0; i < count; i++)
+			task(context, i);
+		return;
+	}
+	unique_lock<mutex> batchGuard(batchLock);
+	runLocked(task, context, count);
+}
+
+//run() for callers that already hold batchLock
+void ThreadPool::runLocked(void (*task)(void*, int), void * context, int count)
+{
+	{
+		unique_lock<mutex> guard(lock);
+		this->task = task;
+		this->context = context;
+		this->count = count;
+		this->next = 0;
+		this->busy = workers.size();
+		this->batch++;
+	}
+	wake.notify_all();
+	runTasks();
+	unique_lock<mutex> guard(lock);
+	done.wait(guard, [&]{ return busy == 0; });
+}
+
+//returns the number of threads that work on tasks (including the caller)
+int ThreadPool::getThreads()
+{
+	return workers.size() + 1;
+}
+
+//the pool shared by every board
+ThreadPool& ThreadPool::shared()
+{
+	static ThreadPool pool;
+	return pool;
+}
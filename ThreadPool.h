@@ -0,0 +1,107 @@
+//Header file for the thread pool class
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* a double ended queue of work items for one worker.
+ * The owner takes items from the back, idle workers steal from the front.
+ */
+class StealQueue
+{
+	std::mutex lock;		//guards head and tail
+	const int * items;		//the items the queue hands out, owned by the caller
+	int head;				//index of the first item left
+	int tail;				//index one past the last item left
+
+public:
+	StealQueue();
+	void reset(const int * items, int begin, int end);	//fills the queue with items [begin, end)
+	bool pop(int& item);								//takes an item from the back, false if the queue is empty
+	bool steal(int& item);								//takes an item from the front, false if the queue is empty
+};
+
+/* a pool of worker threads that stay alive for the whole program.
+ * run() hands out the task indices [0, count) to the workers (and the calling thread)
+ * and blocks until every index has been processed.
+ */
+class ThreadPool
+{
+	std::vector<std::thread> workers;		//the worker threads, the calling thread also does work
+	std::mutex batchLock;					//only one batch runs at a time
+	std::mutex lock;						//guards everything below
+	std::condition_variable wake;			//signalled when a new batch of tasks is posted
+	std::condition_variable done;			//signalled when a worker finishes its share of a batch
+	void (*task)(void*, int);				//the task of the current batch
+	void * context;							//the context passed to task
+	int count;								//number of task indices in the current batch
+	std::atomic<int> next;					//next task index to hand out
+	int busy;								//number of workers still working on the current batch
+	unsigned long long batch;				//incremented for every batch, so workers can tell a new one was posted
+	bool stopping;							//set when the pool is destroyed
+
+	std::unique_ptr<StealQueue[]> queues;	//one work stealing queue per thread
+
+	void workerLoop();						//the loop each worker thread runs
+	void runTasks();						//processes task indices until there are none left
+	void run(void (*task)(void*, int), void * context, int count);
+	void runLocked(void (*task)(void*, int), void * context, int count);	//run() for callers that already hold batchLock
+	bool mustRunInline();					//true if posting a batch would be pointless (or deadlock)
+
+	template <typename FUNCTION>
+	static void trampoline(void * function, int index)
+	{
+		(*(FUNCTION*)function)(index);
+	}
+
+public:
+	ThreadPool(int threads = 0);			//creates a pool with the given number of threads, 0 uses one per core
+	~ThreadPool();
+
+	//calls function(i) for every i in [0, count), spread over the pool; returns when they have all finished
+	template <typename FUNCTION>
+	void run(FUNCTION& function, int count)
+	{
+		run(&ThreadPool::trampoline<FUNCTION>, (void*)&function, count);
+	}
+
+	//calls function(item) for every item in items[0, count). Each thread starts on its own contiguous
+	//share of the items and steals from the others once it runs out, so uneven items still balance out
+	template <typename FUNCTION>
+	void runStealing(FUNCTION& function, const int * items, int count)
+	{
+		if (mustRunInline())
+		{
+			for (int i = 0; i < count; i++)
+				function(items[i]);
+			return;
+		}
+		std::unique_lock<std::mutex> batchGuard(batchLock);
+		int threads = getThreads();
+		for (int i = 0; i < threads; i++)
+			queues[i].reset(items, count * (long long)i / threads, count * (long long)(i + 1) / threads);
+		auto worker = [&](int self)
+		{
+			int item;
+			while (queues[self].pop(item))
+				function(item);
+			for (int i = 1; i < threads; i++)
+			{
+				StealQueue& victim = queues[(self + i) % threads];
+				while (victim.steal(item))
+					function(item);
+			}
+		};
+		runLocked(&ThreadPool::trampoline<decltype(worker)>, (void*)&worker, threads);
+	}
+
+	int getThreads();						//returns the number of threads that work on tasks (including the caller)
+	static ThreadPool& shared();			//the pool shared by every board
+};
+
+#endif /* THREADPOOL_H_ */
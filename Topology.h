@@ -0,0 +1,132 @@
+//Header file for the board topologies
+#ifndef TOPOLOGY_H_
+#define TOPOLOGY_H_
+
+/* the surfaces a bounded board can be, named after the suffixes of Golly's rule strings:
+ * - PLANE (":P"): nothing past the edges.
+ * - TORUS (":T"): the top and bottom edges are joined, and so are the left and right ones.
+ * - KLEIN_BOTTLE (":K"): like the torus, but the top and bottom edges are joined with a
+ *   twist, so going off the top brings a cell back at the bottom mirrored left to right.
+ * - CROSS_SURFACE (":C"): both pairs of edges are joined with a twist.
+ * - SPHERE (":S", square boards only): the top edge is joined to the left edge and the
+ *   bottom edge to the right edge. Nothing lies diagonally past the corners.
+ */
+enum Topology {PLANE, TORUS, KLEIN_BOTTLE, CROSS_SURFACE, SPHERE};
+
+//brings an index up to n outside [0, n) back inside, the way the edges of a torus join
+inline int wrapIndex(int i, int n)
+{
+	while (i < 0)
+		i += n;
+	while (i >= n)
+		i -= n;
+	return i;
+}
+
+/* topology policies: cell() takes a cell outside a height by width board and moves it onto
+ * the board cell it stands for, or returns false if it stands for nothing (dead). The cell
+ * can be further out than one step (Larger than Life margins), but no further than the size
+ * of the board.
+ */
+struct PlaneTopology
+{
+	static inline bool cell(int&, int&, int, int)
+	{
+		return false;
+	}
+};
+
+struct TorusTopology
+{
+	static inline bool cell(int& r, int& c, int height, int width)
+	{
+		r = wrapIndex(r, height);
+		c = wrapIndex(c, width);
+		return true;
+	}
+};
+
+struct KleinBottleTopology
+{
+	static inline bool cell(int& r, int& c, int height, int width)
+	{
+		if (r < 0 || r >= height)
+		{
+			r = wrapIndex(r, height);
+			c = width - 1 - c;
+		}
+		c = wrapIndex(c, width);
+		return true;
+	}
+};
+
+struct CrossSurfaceTopology
+{
+	static inline bool cell(int& r, int& c, int height, int width)
+	{
+		if (r < 0 || r >= height)
+		{
+			r = wrapIndex(r, height);
+			c = width - 1 - c;
+		}
+		if (c < 0 || c >= width)
+		{
+			c = wrapIndex(c, width);
+			r = height - 1 - r;
+		}
+		return true;
+	}
+};
+
+struct SphereTopology
+{
+	static inline bool cell(int& r, int& c, int height, int width)
+	{
+		bool rowOutside = r < 0 || r >= height, columnOutside = c < 0 || c >= width;
+		if (rowOutside == columnOutside)
+			return false;
+		//each edge is mirrored onto the one it is joined to, across the diagonal through their corner
+		int row = r, column = c;
+		if (row < 0)
+		{
+			r = column;
+			c = -1 - row;
+		}
+		else if (row >= height)
+		{
+			r = column;
+			c = 2 * width - 1 - row;
+		}
+		else if (column < 0)
+		{
+			r = -1 - column;
+			c = row;
+		}
+		else
+		{
+			r = 2 * height - 1 - column;
+			c = row;
+		}
+		return r >= 0 && r < height && c >= 0 && c < width;
+	}
+};
+
+//cell() of the given topology, for the code that is not compiled once per topology
+inline bool topologyCell(Topology topology, int& r, int& c, int height, int width)
+{
+	switch (topology)
+	{
+	case TORUS:
+		return TorusTopology::cell(r, c, height, width);
+	case KLEIN_BOTTLE:
+		return KleinBottleTopology::cell(r, c, height, width);
+	case CROSS_SURFACE:
+		return CrossSurfaceTopology::cell(r, c, height, width);
+	case SPHERE:
+		return SphereTopology::cell(r, c, height, width);
+	default:
+		return PlaneTopology::cell(r, c, height, width);
+	}
+}
+
+#endif /* TOPOLOGY_H_ */
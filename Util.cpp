@@ -1,4 +1,5 @@
 #include "Util.h"
+#include "Rule.h"
 
 using namespace std;
 
@@ -13,12 +14,24 @@ int fs_atoi(ifstream &input)
 	return atoi(l.c_str());
 }
 
+/* reads in a line from input, converts it to a 64-bit integer and returns the result
+ */
+long long fs_atoll(ifstream &input)
+{
+	string l;
+	getline(input, l);
+	if(input.eof())
+		throw "EOF Reached";
+	return atoll(l.c_str());
+}
+
 
 /* test that string s ends with ending parameter
  */
 bool endsWith(string s, string ending)
 {
-	return (s.rfind(ending) + ending.length()) == s.length();
+	//compared in place, rfind() missing would wrap around to a match on names shorter than the ending
+	return s.length() >= ending.length() && s.compare(s.length() - ending.length(), ending.length(), ending) == 0;
 }
 
 /* test that string s starts with ending parameter
@@ -48,10 +61,285 @@ set<int> rule2set(string input)
 	set<int> ret;
 	for(auto character : input)
 		if(isdigit(character))
-			ret.insert(atoi((const char*)&character));
+			ret.insert(character - '0');
 	return ret;
 }
 
+/* reads an interval such as "34..58" into min and max, returns false if it is not one
+ */
+static bool readInterval(const string& text, int &min, int &max)
+{
+	size_t dots = text.find("..");
+	if (dots == string::npos || dots == 0 || dots + 2 >= text.size())
+		return false;
+	for (size_t i = 0; i < text.size(); i++)
+		if (!isdigit(text[i]) && (i < dots || i > dots + 1))
+			return false;
+	min = atoi(text.substr(0, dots).c_str());
+	max = atoi(text.substr(dots + 2).c_str());
+	return true;
+}
+
+/* parses a Larger than Life rule in Golly's notation, eg "R5,C0,M1,S34..58,B34..45,NM".
+ * name has had its spaces removed and is in lower case. M1 counts the centre cell as a
+ * neighbour; a dead centre adds nothing, so the survival interval is moved down by one
+ * instead and the rule never counts the centre.
+ */
+static bool string2ltl(const string& name, set<int> &birthRule, set<int> &survivalRule, int &range, char &neighbourhood,
+	int &states)
+{
+	int radius = 0, count = 0, middle = 0;
+	int birthMin = 0, birthMax = -1, survivalMin = 0, survivalMax = -1;
+	bool haveBirth = false, haveSurvival = false;
+	char shape = 'm';
+	size_t start = 0;
+	while (start <= name.size())
+	{
+		size_t comma = name.find(',', start);
+		if (comma == string::npos)
+			comma = name.size();
+		string field = name.substr(start, comma - start);
+		start = comma + 1;
+		if (field.size() < 2)
+			return false;
+		string value = field.substr(1);
+		bool number = value.find_first_not_of("0123456789") == string::npos;
+		if (field[0] == 'b')
+			haveBirth = readInterval(value, birthMin, birthMax);
+		else if (field[0] == 's')
+			haveSurvival = readInterval(value, survivalMin, survivalMax);
+		else if (field[0] == 'n' && value.size() == 1)
+			shape = value[0];
+		else if (field[0] == 'r' && number)
+			radius = atoi(value.c_str());
+		else if (field[0] == 'c' && number)
+			count = atoi(value.c_str());
+		else if (field[0] == 'm' && number)
+			middle = atoi(value.c_str());
+		else
+			return false;
+	}
+	//only the square and diamond shaped neighbourhoods
+	if (radius < 1 || radius > MAX_RANGE || count > MAX_STATES || middle > 1 || (shape != 'm' && shape != 'n') ||
+		!haveBirth || !haveSurvival)
+		return false;
+	if (middle == 1)
+	{
+		survivalMin = (survivalMin > 0) ? survivalMin - 1 : 0;
+		survivalMax--;
+	}
+	//no cell has more neighbours than the square around it holds
+	int most = (2 * radius + 1) * (2 * radius + 1);
+	birthMax = (birthMax < most) ? birthMax : most;
+	survivalMax = (survivalMax < most) ? survivalMax : most;
+	birthRule.clear();
+	survivalRule.clear();
+	for (int count = birthMin; count <= birthMax; count++)
+		birthRule.insert(count);
+	for (int count = survivalMin; count <= survivalMax; count++)
+		survivalRule.insert(count);
+	//a range 1 square is the ordinary Moore neighbourhood, so that is a Life-like rule
+	range = (radius == 1 && shape == 'm') ? 0 : radius;
+	neighbourhood = toupper(shape);
+	states = (count > 2) ? count : 2;
+	return true;
+}
+
+/* reads the birth or survival part of a rule, eg "23" or "2-a3ce", into the counts it names and the
+ * transitions of a cell with the given centre. A count on its own takes every neighbourhood with that
+ * many live neighbours, letters after it (Hensel notation) only the ones they name, or with a '-' in
+ * front every one they do not name.
+ */
+static bool readTransitions(const string& part, int centre, set<int>& counts, vector<bool>& transitions)
+{
+	size_t i = 0;
+	while (i < part.size())
+	{
+		if (part[i] < '0' || part[i] > '8')
+			return false;
+		int count = part[i++] - '0';
+		bool negate = i < part.size() && part[i] == '-';
+		if (negate)
+			i++;
+		vector<int> named;
+		size_t first = i;
+		for (; i < part.size() && isalpha(part[i]); i++)
+			if (!henselNeighbours(count, part[i], named))
+				return false;
+		if (negate && i == first)
+			return false;
+		vector<bool> isNamed(256);
+		for (int neighbours : named)
+			isNamed[neighbours] = true;
+		for (int neighbours = 0; neighbours < 256; neighbours++)
+			if (__builtin_popcount(neighbours) == count && (i == first || isNamed[neighbours] != negate))
+				transitions[(centre << 8) | neighbours] = true;
+		counts.insert(count);
+	}
+	return true;
+}
+
+/* parses a rule string into birth and survival sets, returns false if it is not a rule we can run.
+ * Accepts "B3/S23" (in either order, any case) as well as the older "23/3" notation,
+ * which gives survival first, and the name "Life". Anything after a ':' (the topology in
+ * Golly's notation) is ignored. Larger than Life rules ("R5,C0,M1,S34..58,B34..45,NM")
+ * set range to their radius and neighbourhood to 'M' or 'N', Life-like rules set range to 0.
+ * Generations rules give their number of states as a third part, "B2/S/C3" or "/2/3",
+ * or in the C field of a Larger than Life rule; states is 2 for every other rule.
+ * Isotropic non-totalistic rules ("B2-a/S12") fill transitions with their 512 entry table
+ * (see Rule), it is left empty for every other rule. Life-like rules ending in H or V
+ * ("B2/S34H") set neighbourhood to 'H' (hexagonal) or 'N' (von Neumann), otherwise 'M'.
+ */
+bool string2rule(string input, set<int> &birthRule, set<int> &survivalRule, int &range, char &neighbourhood, int &states,
+	vector<bool> &transitions)
+{
+	input = input.substr(0, input.find(':'));
+	string name;
+	for (auto character : input)
+		if (!isspace(character))
+			name += tolower(character);
+	if (name == "life")
+	{
+		birthRule = {3,};
+		survivalRule = {2, 3,};
+		range = 0;
+		neighbourhood = 'M';
+		states = 2;
+		transitions.clear();
+		return true;
+	}
+	if (!name.empty() && name[0] == 'r')
+	{
+		transitions.clear();
+		return string2ltl(name, birthRule, survivalRule, range, neighbourhood, states);
+	}
+	//a hexagonal or von Neumann neighbourhood is a letter at the very end, as in Golly
+	char shape = 'M';
+	if (!name.empty() && (name[name.size() - 1] == 'h' || name[name.size() - 1] == 'v'))
+	{
+		shape = (name[name.size() - 1] == 'h') ? 'H' : 'N';
+		name.erase(name.size() - 1);
+	}
+	//two or three parts separated by slashes
+	vector<string> parts;
+	size_t start = 0;
+	while (true)
+	{
+		size_t slash = name.find('/', start);
+		parts.push_back(name.substr(start, slash - start));
+		if (slash == string::npos)
+			break;
+		start = slash + 1;
+	}
+	if (parts.size() < 2 || parts.size() > 3)
+		return false;
+	set<int> birth, survival;
+	vector<bool> table(512);
+	int count = 2;
+	bool haveBirth = false, haveSurvival = false, haveStates = false, letters = false;
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		string part = parts[i];
+		char prefix = part.empty() ? 0 : toupper(part[0]);
+		if (prefix == 'B' || prefix == 'S' || prefix == 'C' || prefix == 'G')
+			part = part.substr(1);
+		else
+			prefix = "SBC"[i];	//no letters: survival/birth/states
+		if (prefix == 'B' || prefix == 'S')
+		{
+			if (!readTransitions(part, (prefix == 'S') ? 1 : 0, (prefix == 'S') ? survival : birth, table))
+				return false;
+			letters = letters || part.find_first_not_of("0123456789") != string::npos;
+			if (prefix == 'B')
+				haveBirth = true;
+			else
+				haveSurvival = true;
+		}
+		else
+		{
+			if (part.find_first_not_of("0123456789") != string::npos)
+				return false;
+			count = atoi(part.c_str());
+			haveStates = !part.empty();
+		}
+	}
+	if (!haveBirth || !haveSurvival || (parts.size() == 3 && !haveStates) || count > MAX_STATES)
+		return false;
+	//Hensel letters name Moore neighbourhoods, and the smaller neighbourhoods cannot have 8 neighbours
+	int most = (shape == 'H') ? 6 : ((shape == 'N') ? 4 : 8);
+	if ((shape != 'M' && letters) || (!birth.empty() && *birth.rbegin() > most) ||
+		(!survival.empty() && *survival.rbegin() > most))
+		return false;
+	birthRule = birth;
+	survivalRule = survival;
+	range = 0;
+	neighbourhood = shape;
+	states = (count > 2) ? count : 2;
+	transitions = letters ? table : vector<bool>();
+	return true;
+}
+
+/* reads the topology from the suffix of a rule string in Golly's notation, eg "B3/S23:K100*,50"
+ * for a Klein bottle, and leaves topology as it is if there is none. The size after the letter
+ * is ignored, the board has its own. Returns false for a topology the board does not have (a
+ * Klein bottle is only twisted across its top and bottom edges, which Golly marks with a '*'
+ * after the width).
+ */
+bool string2topology(string input, Topology &topology)
+{
+	size_t colon = input.find(':');
+	if (colon == string::npos)
+		return true;
+	string suffix;
+	for (size_t i = colon + 1; i < input.size(); i++)
+		if (!isspace(input[i]))
+			suffix += tolower(input[i]);
+	if (suffix.empty())
+		return true;
+	size_t comma = suffix.find(',');
+	switch (suffix[0])
+	{
+	case 'p':
+		topology = PLANE;
+		return true;
+	case 't':
+		topology = TORUS;
+		return true;
+	case 'k':
+		topology = KLEIN_BOTTLE;
+		return comma == string::npos || suffix.find('*', comma) == string::npos;
+	case 'c':
+		topology = CROSS_SURFACE;
+		return true;
+	case 's':
+		topology = SPHERE;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* reads the size from the suffix of a rule string in Golly's notation, eg 100 by 50 from
+ * "B3/S23:T50,100", and returns false if there is none. Without a height (as on a sphere) the
+ * board is as high as it is wide, and a 0 (an unbounded side in Golly) is left as 0.
+ */
+bool string2size(string input, int &height, int &width)
+{
+	size_t colon = input.find(':');
+	if (colon == string::npos)
+		return false;
+	string suffix;
+	for (size_t i = colon + 1; i < input.size(); i++)
+		if (!isspace(input[i]))
+			suffix += tolower(input[i]);
+	if (suffix.size() < 2 || !isdigit(suffix[1]))
+		return false;
+	width = atoi(suffix.c_str() + 1);
+	size_t comma = suffix.find(',');
+	height = (comma == string::npos) ? width : atoi(suffix.c_str() + comma + 1);
+	return true;
+}
+
 /* converts an integer set eg {1, 2, 3}
  * to an string, eg: "123"
  */
@@ -1,31 +1,45 @@
 #ifndef UTIL_H_
 #define UTIL_H_
 
+#include <cstdint>
 #include <fstream>
 #include <stdlib.h>
 #include <vector>
 #include <string>
 #include <set>
+#include "Topology.h"
 
 using namespace std;
 
 int fs_atoi(ifstream &input);
+long long fs_atoll(ifstream &input);
 bool startsWith(string s, string starting);
 bool endsWith(string s, string ending);
 string separator();
 set<int> rule2set(string input);
 string set2rule(set<int> input);
+bool string2rule(string input, set<int> &birthRule, set<int> &survivalRule, int &range, char &neighbourhood, int &states,
+	vector<bool> &transitions);
+bool string2topology(string input, Topology &topology);
+bool string2size(string input, int &height, int &width);
 
 struct BoardData{
     bool wrapAround;
     int height;
     int width;
-    int iterations;
-    int births;
-    int deaths;
+    long long iterations;
+    long long births;
+    long long deaths;
 	set<int> birthRule;
 	set<int> survivalRule;
+	int range;			//0 for Life-like rules, otherwise the Larger than Life radius
+	char neighbourhood;	//'M' for Moore, 'N' for von Neumann
+	int states;			//number of cell states, more than 2 for Generations rules
+	vector<bool> transitions;	//non-totalistic rules: whether each of the 512 neighbourhoods is alive next (see Rule), empty otherwise
     vector< vector<bool> > matrix;
+	vector< vector<unsigned char> > cellStates;	//the state of every cell for Generations rules, empty if every cell is dead or alive
+	Topology topology;	//the surface the board is: the rule string's suffix if it has one, otherwise the torus if wrapAround is set
+	vector<uint64_t> packed;	//the live cells packed as Board packs them (64 to a word, (width + 63) / 64 words a row), matrix is empty when the loader fills this
 };
 
 #endif /* UTIL_H_ */